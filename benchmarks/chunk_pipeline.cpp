@@ -0,0 +1,293 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+#include "world/World.h"
+#include "init/Blocks.h"
+#include "debug/DebugSettings.h"
+#include "util/Logging.h"
+#include "util/MathUtil.h"
+
+// Headless benchmarks of the chunk pipeline, every one builds the same world around the origin.
+// Run with --benchmark_out=results.json --benchmark_out_format=json to compare versions
+
+namespace {
+
+const int SEED = 1234;
+const int RENDER_DISTANCE = 4;
+// The stages run again on the chunks within this many chunks of the origin, all of them lit and meshed
+const int STAGE_RADIUS = 2;
+
+std::atomic<int64_t> s_allocations = 0;
+
+} // namespace
+
+// Counts every allocation made by the game, the workers included
+void* operator new(size_t size) {
+  s_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* pointer = std::malloc(size == 0 ? 1 : size)) return pointer;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+  std::free(pointer);
+}
+
+namespace {
+
+class BenchmarkCamera : public Entity {
+public:
+  BoundingBox GetBoundingBox() const override { return {}; }
+  double GetEyeLevel() const override { return 0.0; }
+};
+
+void UseBenchmarkSettings(int workers) {
+  DebugSettings& settings = DebugSettings::instance;
+  settings = DebugSettings();
+  settings.seed = SEED;
+  settings.saveWorld = false;
+  settings.useTerrainCache = false;
+  settings.blockAtlasCacheFile = "";
+  settings.lodDistance = 0;
+  settings.renderDistance = RENDER_DISTANCE;
+  settings.inMemoryBorder = 0;
+  settings.terrainWorkerCount = workers;
+  settings.lightingWorkerCount = workers;
+  settings.meshWorkerCount = workers;
+}
+
+// A world without a render backend, built until its workers have nothing left to do
+class BenchmarkWorld {
+public:
+  BenchmarkWorld() : m_world(m_camera) {}
+  ~BenchmarkWorld() { m_world.Stop(); }
+
+  // Returns false if the world didn't settle in time
+  bool Build() {
+    m_world.Start();
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(300);
+    while (!IsBuilt()) {
+      if (std::chrono::steady_clock::now() > deadline) return false;
+      m_world.Update();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+  }
+
+  int GetBuiltChunkCount() const {
+    return (int)m_world.GetActiveChunks().size();
+  }
+
+  std::vector<std::shared_ptr<Chunk>> GetStageArea() const {
+    std::vector<std::shared_ptr<Chunk>> area;
+    for (int x = -STAGE_RADIUS; x <= STAGE_RADIUS; x++) {
+      for (int z = -STAGE_RADIUS; z <= STAGE_RADIUS; z++) {
+        area.push_back(m_world.GetChunkAt({ x, z }));
+      }
+    }
+    return area;
+  }
+
+private:
+  BenchmarkCamera m_camera;
+  World m_world;
+
+  bool IsLit(glm::ivec2 chunkCoord) const {
+    std::shared_ptr<Chunk> chunk = m_world.GetChunkAt(chunkCoord);
+    return chunk != nullptr && chunk->GetState() >= PROPAGATED_LIGHTING;
+  }
+
+  // Every active chunk is lit, and meshed once its neighbors are lit too
+  bool IsBuilt() const {
+    if (m_world.GetActiveChunks().empty()) return false;
+    if (m_world.GetChunksToGenerateTerrainSize() > 0 || m_world.GetChunksToLightSize() > 0
+      || m_world.GetChunksToGenerateMeshSize() > 0) return false;
+
+    for (const std::shared_ptr<Chunk>& chunk : m_world.GetActiveChunks()) {
+      if (chunk->GetState() < PROPAGATED_LIGHTING) return false;
+
+      bool meshable = true;
+      for (int x = -1; x <= 1; x++) {
+        for (int z = -1; z <= 1; z++) {
+          meshable = meshable && IsLit(chunk->GetChunkCoord() + glm::ivec2(x, z));
+        }
+      }
+      if (meshable && chunk->GetState() < APPLIED_MESH) return false;
+    }
+    return true;
+  }
+};
+
+// The stage benchmarks share one world, its workers sit idle once it's built since nothing is queued until the next
+// World::Update
+BenchmarkWorld& GetStageWorld() {
+  static std::unique_ptr<BenchmarkWorld> world;
+  if (world == nullptr) {
+    UseBenchmarkSettings(1);
+    world = std::make_unique<BenchmarkWorld>();
+    if (!world->Build()) LOG(FATAL) << "The benchmark world didn't finish building";
+  }
+  return *world;
+}
+
+void ReportChunks(benchmark::State& state, int chunksPerIteration, int64_t allocations) {
+  state.counters["chunks/s"] = benchmark::Counter(chunksPerIteration, benchmark::Counter::kIsIterationInvariantRate);
+  state.counters["allocs/chunk"] = (double)allocations / (double)(state.iterations() * chunksPerIteration);
+}
+
+// Height of the first free block above the chunk's middle column
+int GetSurfaceHeight(Chunk& chunk) {
+  int y = Chunk::CHUNK_HEIGHT - 2;
+  while (y > 0 && chunk.GetBlockstateAt(8, y, 8) == Blocks::AIR.GetBlockstate()) y--;
+  return y + 1;
+}
+
+} // namespace
+
+static void BM_WorldSpinUp(benchmark::State& state) {
+  UseBenchmarkSettings((int)state.range(0));
+
+  int chunks = 0;
+  int64_t allocations = 0;
+  for (auto _ : state) {
+    int64_t allocationsBefore = s_allocations;
+    auto world = std::make_unique<BenchmarkWorld>();
+    if (!world->Build()) {
+      state.SkipWithError("The world didn't finish building");
+      break;
+    }
+    allocations += s_allocations - allocationsBefore;
+    chunks = world->GetBuiltChunkCount();
+
+    // Unloading isn't part of the spin-up
+    state.PauseTiming();
+    world.reset();
+    state.ResumeTiming();
+  }
+
+  if (chunks > 0) ReportChunks(state, chunks, allocations);
+}
+
+static void WorkerCounts(benchmark::internal::Benchmark* benchmark) {
+  int maxWorkers = std::max(1, (int)std::thread::hardware_concurrency());
+  for (int workers = 1; workers < maxWorkers; workers *= 2) {
+    benchmark->Arg(workers);
+  }
+  benchmark->Arg(maxWorkers);
+}
+
+BENCHMARK(BM_WorldSpinUp)->Apply(WorkerCounts)->ArgName("workers")->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_GenerateTerrain(benchmark::State& state) {
+  std::vector<std::shared_ptr<Chunk>> area = GetStageWorld().GetStageArea();
+
+  int64_t allocations = 0;
+  for (auto _ : state) {
+    int64_t allocationsBefore = s_allocations;
+    for (const std::shared_ptr<Chunk>& chunk : area) {
+      chunk->ResetGeneration(GenerationStage::HEIGHTMAP);
+      chunk->RegenerateTerrain();
+    }
+    allocations += s_allocations - allocationsBefore;
+
+    // Leave the chunks lit for the next stages
+    state.PauseTiming();
+    for (const std::shared_ptr<Chunk>& chunk : area) chunk->FinishTerrain();
+    for (const std::shared_ptr<Chunk>& chunk : area) chunk->PropagateLighting();
+    state.ResumeTiming();
+  }
+
+  ReportChunks(state, (int)area.size(), allocations);
+}
+
+BENCHMARK(BM_GenerateTerrain)->Unit(benchmark::kMillisecond);
+
+static void BM_PropagateLighting(benchmark::State& state) {
+  std::vector<std::shared_ptr<Chunk>> area = GetStageWorld().GetStageArea();
+
+  int64_t allocations = 0;
+  for (auto _ : state) {
+    // Sets the lights back to the unspread ones
+    state.PauseTiming();
+    for (const std::shared_ptr<Chunk>& chunk : area) chunk->FinishTerrain();
+    state.ResumeTiming();
+
+    int64_t allocationsBefore = s_allocations;
+    for (const std::shared_ptr<Chunk>& chunk : area) chunk->PropagateLighting();
+    allocations += s_allocations - allocationsBefore;
+  }
+
+  ReportChunks(state, (int)area.size(), allocations);
+}
+
+BENCHMARK(BM_PropagateLighting)->Unit(benchmark::kMillisecond);
+
+// Places a glowstone on the surface of every chunk and removes it again
+static void BM_PropagateLightingAtPos(benchmark::State& state) {
+  std::vector<std::shared_ptr<Chunk>> area = GetStageWorld().GetStageArea();
+  Blockstate air = Blocks::AIR.GetBlockstate();
+  Blockstate glowstone = Blocks::GLOWSTONE.GetBlockstate();
+
+  std::vector<glm::ivec3> positions;
+  for (const std::shared_ptr<Chunk>& chunk : area) {
+    positions.push_back({ 8, GetSurfaceHeight(*chunk), 8 });
+  }
+
+  int64_t allocations = 0;
+  for (auto _ : state) {
+    int64_t allocationsBefore = s_allocations;
+    for (size_t i = 0; i < area.size(); i++) {
+      area[i]->SetBlockstateAt(XYZ(positions[i]), glowstone);
+      area[i]->PropagateLightingAtPos(positions[i], air, glowstone);
+      area[i]->SetBlockstateAt(XYZ(positions[i]), air);
+      area[i]->PropagateLightingAtPos(positions[i], glowstone, air);
+    }
+    allocations += s_allocations - allocationsBefore;
+  }
+
+  int updates = 2 * (int)area.size();
+  state.counters["updates/s"] = benchmark::Counter(updates, benchmark::Counter::kIsIterationInvariantRate);
+  state.counters["allocs/update"] = (double)allocations / (double)(state.iterations() * updates);
+}
+
+BENCHMARK(BM_PropagateLightingAtPos)->Unit(benchmark::kMicrosecond);
+
+static void BM_GenerateMesh(benchmark::State& state) {
+  std::vector<std::shared_ptr<Chunk>> area = GetStageWorld().GetStageArea();
+
+  int64_t allocations = 0;
+  for (auto _ : state) {
+    int64_t allocationsBefore = s_allocations;
+    for (const std::shared_ptr<Chunk>& chunk : area) chunk->GenerateMesh();
+    allocations += s_allocations - allocationsBefore;
+  }
+
+  ReportChunks(state, (int)area.size(), allocations);
+}
+
+BENCHMARK(BM_GenerateMesh)->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv) {
+  Logger::setLogLevel(WARN);
+
+  // Meshing needs the atlas for the texture coordinates, it's built once outside of the benchmarks
+  UseBenchmarkSettings(1);
+  Blocks::InitializeBlocks();
+  Blocks::GenerateBlockAtlas();
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -3,8 +3,12 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aColor;
 
-uniform mat4 projection;
-uniform mat4 view;
+// Frame data shared by every program, filled in by ShaderLibrary
+layout (std140) uniform Camera {
+  mat4 projection;
+  mat4 view;
+  mat4 projection2D;
+};
 uniform mat4 model;
 
 out vec3 color;
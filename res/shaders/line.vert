@@ -5,8 +5,12 @@ layout (location = 0) in vec3 aPos;
 uniform vec3 start;
 uniform vec3 end;
 
-uniform mat4 projection;
-uniform mat4 view;
+// Frame data shared by every program, filled in by ShaderLibrary
+layout (std140) uniform Camera {
+  mat4 projection;
+  mat4 view;
+  mat4 projection2D;
+};
 
 void main() {
   vec3 position = start;
@@ -3,18 +3,40 @@
 out vec4 fragColor;
 in vec2 texCoords;
 in vec2 light;
+in vec3 localPos;
 
 uniform sampler2D tex;
 uniform bool nightVision;
 uniform bool nightTime;
 
+// Subchunk light volume, with one cell of border: (sky * open, block * open, open)
+uniform sampler3D lightVolume;
+uniform bool useLightVolume;
+uniform bool smoothLighting;
+
 float ambientLighting = 0.1;
+const float LIGHT_VOLUME_SIZE = 18.0;
+
+vec2 sampleLightVolume() {
+  // Points out of the visible side of the face, whichever way it was wound
+  vec3 normal = round(normalize(cross(dFdx(localPos), dFdy(localPos))));
+
+  // Half a cell out of the face is the middle of the open cell in front of it
+  vec3 cell = localPos + normal * 0.5;
+  if (!smoothLighting) cell = floor(cell) + 0.5;
+
+  // Filtering averages the premultiplied lights and the open weights alike, so dividing leaves the average of the
+  // open cells and walls don't darken the face
+  vec4 texel = texture(lightVolume, (cell + 1.0) / LIGHT_VOLUME_SIZE);
+  return texel.b > 0.0 ? texel.rg / texel.b : vec2(0.0);
+}
 
 void main() {
 
   // light = vec2(sky, block)
-  float maxLight = max(light.x, light.y);
-  if (nightTime) maxLight = light.y;
+  vec2 faceLight = useLightVolume ? sampleLightVolume() : light;
+  float maxLight = max(faceLight.x, faceLight.y);
+  if (nightTime) maxLight = faceLight.y;
   
   if (nightVision) {
     ambientLighting = 0.8;
@@ -22,7 +44,9 @@ void main() {
   float lightLevel = (maxLight * (1 - ambientLighting)) + ambientLighting;
   vec4 texColor = texture(tex, texCoords);
 
+#ifdef ALPHA_CUTOUT
   if (texColor.a < 0.5) discard;
+#endif
 
   fragColor = vec4(texColor.xyz * lightLevel, texColor.a);
 }
\ No newline at end of file
@@ -5,13 +5,20 @@ layout (location = 2) in vec2 aLight;
 
 out vec2 texCoords;
 out vec2 light;
+out vec3 localPos;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+// Frame data shared by every program, filled in by ShaderLibrary
+layout (std140) uniform Camera {
+  mat4 projection;
+  mat4 view;
+  mat4 projection2D;
+};
 
 void main() {
   gl_Position = projection * view * model * vec4(aPos, 1.0);
   texCoords = aTexCoords;
   light = aLight;
+  localPos = aPos;
 }
\ No newline at end of file
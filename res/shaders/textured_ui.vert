@@ -5,7 +5,13 @@ layout (location = 0) in vec2 aPos;
 out vec2 texCoords;
 
 uniform mat4 model;
-uniform mat4 projection2D;
+
+// Frame data shared by every program, filled in by ShaderLibrary
+layout (std140) uniform Camera {
+  mat4 projection;
+  mat4 view;
+  mat4 projection2D;
+};
 
 void main() {
 
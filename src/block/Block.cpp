@@ -55,6 +55,11 @@ Block& Block::TransparentHidesNeighbors() {
   return *this;
 }
 
+Block& Block::Layer(RenderLayer layer) {
+  m_renderLayer = layer;
+  return *this;
+}
+
 bool Block::IsSolid() const {
   return m_isSolid;
 }
@@ -70,3 +75,7 @@ bool Block::IsAir() const {
 char Block::GetLightLevel() const {
   return m_lightLevel;
 }
+
+RenderLayer Block::GetRenderLayer() const {
+  return m_renderLayer;
+}
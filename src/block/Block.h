@@ -7,6 +7,17 @@
 
 using Blockstate = unsigned char;
 
+// Chunk meshes keep one bucket per layer, drawn in this order
+enum class RenderLayer : unsigned char {
+  // Fully covers its faces
+  SOLID,
+  // Pixels are either opaque or left out
+  CUTOUT,
+  // Blended over whatever is behind it, so its quads are drawn back to front
+  TRANSLUCENT
+};
+const int RENDER_LAYER_COUNT = 3;
+
 class Block : public RegistryItem {
 public:
   Block() = default;
@@ -26,11 +37,13 @@ public:
   Block& Air();
   Block& LightLevel(char lightLevel);
   Block& TransparentHidesNeighbors();
+  Block& Layer(RenderLayer layer);
 
   bool IsSolid() const;
   bool ShouldHideNeighbors() const;
   bool IsAir() const;
   char GetLightLevel() const;
+  RenderLayer GetRenderLayer() const;
 
 private:
   BlockTextures m_textures;
@@ -41,6 +54,7 @@ private:
   bool m_isAir = false;
   bool m_transparentHideNeighbors = false;
   char m_lightLevel = 0;
+  RenderLayer m_renderLayer = RenderLayer::SOLID;
 
   static char s_blockstateIndex;
   static std::unordered_map<char, Block*> s_blockstateMap;
@@ -2,8 +2,14 @@
 #include <GLFW/glfw3.h>
 #include <imgui/imgui.h>
 #include <sys/types.h>
+#ifdef __APPLE__
 #include <sys/sysctl.h>
 #include <mach/mach.h>
+#elif defined(__linux__)
+#include <sys/sysinfo.h>
+#include <unistd.h>
+#include <fstream>
+#endif
 #include <string>
 #include <optional>
 #include <glm/gtc/matrix_transform.hpp>
@@ -17,7 +23,7 @@
 #include "rendering/meshes/ColoredLinesMesh.h"
 
 
-#include "util/Noise.h"
+#include "util/noise/NoiseGenerator.h"
 #include "rendering/textures/Texture.h"
 #include "util/Logging.h"
 #include "util/MathUtil.h"
@@ -39,11 +45,14 @@ namespace {
 std::vector<unsigned char> CreateNoiseImage(int width, int height, double noiseScale, double offsetX, double offsetY, int octaves, double persistence, double lacunarity) {
   std::vector<unsigned char> data(width * height * 4);
 
+  NoiseGenerator noise(DebugSettings::instance.seed);
+  FractalNoise2D fractal = FractalNoise2D::FromScale(noiseScale, offsetX, offsetY, octaves, persistence, lacunarity);
+
   for (int yi = 0; yi < height; yi++) {
     double y = yi;
     for (int xi = 0; xi < width; xi++) {
       double x = xi;
-      double val = Noise::Noise2D(x, y, offsetX, offsetY, noiseScale, octaves, persistence, lacunarity);
+      double val = noise.Noise2D(x, y, fractal);
       int mappedVal = floor(((val + 1) / 2.0) * 255);
       data[(xi + yi * width) * 4] = mappedVal;
       data[(xi + yi * width) * 4 + 1] = mappedVal;
@@ -153,6 +162,61 @@ void DrawChunkBoundaries(const glm::dvec3& playerPosition) {
 
 }
 
+struct MemoryUsage {
+  size_t process = 0;
+  size_t used = 0;
+  size_t total = 0;
+};
+
+// Left at zero on platforms without an implementation
+MemoryUsage GetMemoryUsage() {
+  MemoryUsage memory;
+#ifdef __APPLE__
+  mach_task_basic_info info;
+  mach_msg_type_number_t infoCount = MACH_TASK_BASIC_INFO_COUNT;
+
+  if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &infoCount) != KERN_SUCCESS) {
+    LOG(FATAL) << "Failed to get process memory usage.";
+  }
+
+  memory.process = info.resident_size;
+
+  int mib[2] = { CTL_HW, HW_MEMSIZE };
+  size_t length = sizeof(memory.total);
+
+  if (sysctl(mib, 2, &memory.total, &length, nullptr, 0) != 0) {
+    LOG(FATAL) << "Failed to get total system memory.";
+  }
+
+  // Get used and free memory using host_statistics
+  mach_msg_type_number_t count = HOST_VM_INFO_COUNT;
+  vm_statistics64_data_t vmStats;
+  if (host_statistics64(mach_host_self(), HOST_VM_INFO, reinterpret_cast<host_info_t>(&vmStats), &count) == KERN_SUCCESS) {
+    size_t pageSize = vm_kernel_page_size;
+
+    size_t activeMemory = vmStats.active_count * pageSize;
+    size_t inactiveMemory = vmStats.inactive_count * pageSize;
+    size_t wiredMemory = vmStats.wire_count * pageSize;
+
+    memory.used = activeMemory + inactiveMemory + wiredMemory;
+  }
+#elif defined(__linux__)
+  // The second field is the resident size in pages
+  size_t totalPages, residentPages;
+  std::ifstream statm("/proc/self/statm");
+  if (statm >> totalPages >> residentPages) {
+    memory.process = residentPages * sysconf(_SC_PAGESIZE);
+  }
+
+  struct sysinfo info;
+  if (sysinfo(&info) == 0) {
+    memory.total = (size_t)info.totalram * info.mem_unit;
+    memory.used = (size_t)(info.totalram - info.freeram - info.bufferram) * info.mem_unit;
+  }
+#endif
+  return memory;
+}
+
 } // namespace
 
 void DebugInformation::ShowIfActive(World& world, const PlayerEntity& player) {
@@ -212,42 +276,15 @@ void DebugInformation::ShowIfActive(World& world, const PlayerEntity& player) {
     ImGui::Text("Terrain queue: %d", world.GetChunksToGenerateTerrainSize());
     ImGui::Text("Lighting queue: %d", world.GetChunksToLightSize());
     ImGui::Text("Mesh queue: %d", world.GetChunksToGenerateMeshSize());
+    ImGui::Text("Reclaim queue: %d", world.GetChunksToReclaimSize());
+    ImGui::Text("LOD tiles: %d (%zu MB)", world.GetLodTileCount(), world.GetLodMemoryUsage() / (1024 * 1024));
+    ImGui::Text("LOD queue: %d", world.GetLodTilesToGenerateSize());
 
     ImGui::Text("");
 
-    mach_task_basic_info info;
-    mach_msg_type_number_t infoCount = MACH_TASK_BASIC_INFO_COUNT;
-
-    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &infoCount) != KERN_SUCCESS) {
-      LOG(FATAL) << "Failed to get process memory usage.";
-    }
-
-    size_t processMemory = info.resident_size;
-
-    int mib[2] = { CTL_HW, HW_MEMSIZE };
-    size_t totalMemory;
-    size_t length = sizeof(totalMemory);
-
-    if (sysctl(mib, 2, &totalMemory, &length, nullptr, 0) != 0) {
-      LOG(FATAL) << "Failed to get total system memory.";
-    }
-
-    // Get used and free memory using host_statistics
-    size_t usedMemory = 0;
-    mach_msg_type_number_t count = HOST_VM_INFO_COUNT;
-    vm_statistics64_data_t vmStats;
-    if (host_statistics64(mach_host_self(), HOST_VM_INFO, reinterpret_cast<host_info_t>(&vmStats), &count) == KERN_SUCCESS) {
-      size_t pageSize = vm_kernel_page_size;
-
-      size_t activeMemory = vmStats.active_count * pageSize;
-      size_t inactiveMemory = vmStats.inactive_count * pageSize;
-      size_t wiredMemory = vmStats.wire_count * pageSize;
-
-      usedMemory = activeMemory + inactiveMemory + wiredMemory;
-    }
-
-    ImGui::Text("RAM used: %zu MB", processMemory / (1024 * 1024));
-    ImGui::Text("Total RAM: %zu MB / %zu MB", usedMemory / (1024 * 1024), totalMemory / (1024 * 1024));
+    MemoryUsage memory = GetMemoryUsage();
+    ImGui::Text("RAM used: %zu MB", memory.process / (1024 * 1024));
+    ImGui::Text("Total RAM: %zu MB / %zu MB", memory.used / (1024 * 1024), memory.total / (1024 * 1024));
 
     ImGui::Text("");
 
@@ -269,8 +306,13 @@ void DebugInformation::ShowIfActive(World& world, const PlayerEntity& player) {
 
       ImGui::SliderFloat("FOV", &DebugSettings::instance.defaultFOV, 0.0f, 360.0f, "%.0fº");
       ImGui::SliderInt("Render distance", &DebugSettings::instance.renderDistance, 1, 64);
+      ImGui::SliderInt("LOD distance", &DebugSettings::instance.lodDistance, 0, 512);
+      ImGui::InputInt("LOD memory budget (MB)", &DebugSettings::instance.lodMemoryBudgetMB);
       ImGui::Checkbox("Night vision", &DebugSettings::instance.nightVision);
       ImGui::Checkbox("Night time", &DebugSettings::instance.nightTime);
+      if (ImGui::Checkbox("Light volumes", &DebugSettings::instance.useLightVolumes)) {
+        world.RemeshAllChunks();
+      }
 
       if (ImGui::Button(DebugSettings::instance.updateWorld ? "Stop updating world" : "Continue updating world")) {
         DebugSettings::instance.updateWorld = !DebugSettings::instance.updateWorld;
@@ -280,6 +322,11 @@ void DebugInformation::ShowIfActive(World& world, const PlayerEntity& player) {
       ImGui::InputInt("Terrain workers", &DebugSettings::instance.terrainWorkerCount);
       ImGui::InputInt("Lighting workers", &DebugSettings::instance.lightingWorkerCount);
       ImGui::InputInt("Mesh workers", &DebugSettings::instance.meshWorkerCount);
+      ImGui::InputInt("Chunk unloads per frame", &DebugSettings::instance.maxChunkUnloadsPerFrame);
+      ImGui::InputInt("Parallel generation below queue size", &DebugSettings::instance.parallelGenerationQueueDepth);
+      ImGui::InputInt("LOD workers", &DebugSettings::instance.lodWorkerCount);
+      ImGui::InputInt("LOD uploads per frame", &DebugSettings::instance.maxLodUploadsPerFrame);
+      ImGui::Checkbox("Save world", &DebugSettings::instance.saveWorld);
 
       if (ImGui::Button("Reset workers")) {
         world.ResetWorkers();
@@ -309,7 +356,10 @@ void DebugInformation::ShowIfActive(World& world, const PlayerEntity& player) {
 
     if (ImGui::BeginTabItem("Data")) {
 
+      ImGui::Checkbox("Use shader cache", &DebugSettings::instance.useShaderCache);
       if (ImGui::Button("Reload shaders")) {
+        const DebugSettings& settings = DebugSettings::instance;
+        ShaderLibrary::GetInstance().SetBinaryCacheDirectory(settings.useShaderCache ? settings.shaderCacheDirectory : "");
         ShaderLibrary::GetInstance().ReloadShaders();
       }
 
@@ -322,6 +372,9 @@ void DebugInformation::ShowIfActive(World& world, const PlayerEntity& player) {
     }
 
     if (ImGui::BeginTabItem("Terrain generation")) {
+      ImGui::InputInt("Seed", &DebugSettings::instance.seed);
+      ImGui::Checkbox("Use terrain cache", &DebugSettings::instance.useTerrainCache);
+      ImGui::Text("");
       ImGui::InputDouble("Noise scale", &DebugSettings::instance.noiseScale);
       ImGui::InputFloat2("Noise offset", DebugSettings::instance.noiseOffsets);
       ImGui::Text("");
@@ -336,11 +389,14 @@ void DebugInformation::ShowIfActive(World& world, const PlayerEntity& player) {
       ImGui::InputDouble("Cave noise scale", &DebugSettings::instance.caveNoiseScale);
       ImGui::InputDouble("Cave threshold", &DebugSettings::instance.caveThreshold);
       ImGui::InputFloat3("Cave noise offset", DebugSettings::instance.caveNoiseOffsets);
+      ImGui::SliderInt("Cave sample spacing", &DebugSettings::instance.caveSpacing, 1, 8);
       ImGui::Separator();
       ImGui::InputDouble("Coal noise scale", &DebugSettings::instance.coalScale);
       ImGui::InputDouble("Coal threshold", &DebugSettings::instance.coalThreshold);
       ImGui::InputDouble("Iron noise scale", &DebugSettings::instance.ironScale);
       ImGui::InputDouble("iron threshold", &DebugSettings::instance.ironThreshold);
+      ImGui::SliderInt("Coal sample spacing", &DebugSettings::instance.coalSpacing, 1, 8);
+      ImGui::SliderInt("Iron sample spacing", &DebugSettings::instance.ironSpacing, 1, 8);
 
       ImGui::Text("");
       if (ImGui::Button("Regenerate world")) {
@@ -1,3 +1,57 @@
 #include "DebugSettings.h"
 
-DebugSettings DebugSettings::instance;
\ No newline at end of file
+#include "util/Hash.h"
+
+DebugSettings DebugSettings::instance;
+namespace {
+// Bump when the terrain generator changes its output, so old caches aren't used anymore
+const uint32_t TERRAIN_GENERATOR_VERSION = 4;
+} // namespace
+
+uint64_t DebugSettings::GetGenerationStageHash(GenerationStage stage) const {
+  uint64_t hash = Hash::FNV_OFFSET_BASIS;
+
+  // Every stage samples noise made from the seed
+  Hash::AddValue(hash, TERRAIN_GENERATOR_VERSION);
+  Hash::AddValue(hash, seed);
+  Hash::AddValue(hash, stage);
+
+  switch (stage) {
+    case GenerationStage::HEIGHTMAP:
+      Hash::AddValue(hash, noiseScale);
+      Hash::AddValue(hash, octaves);
+      Hash::AddValue(hash, persistence);
+      Hash::AddValue(hash, lacunarity);
+      Hash::AddValue(hash, noiseOffsets);
+      Hash::AddValue(hash, baseTerrainHeight);
+      Hash::AddValue(hash, terrainRange);
+      break;
+    case GenerationStage::SCULPT:
+      Hash::AddValue(hash, caveNoiseScale);
+      Hash::AddValue(hash, caveThreshold);
+      Hash::AddValue(hash, caveNoiseOffsets);
+      Hash::AddValue(hash, caveSpacing);
+      break;
+    case GenerationStage::PAINT:
+      Hash::AddValue(hash, coalThreshold);
+      Hash::AddValue(hash, coalScale);
+      Hash::AddValue(hash, coalSpacing);
+      Hash::AddValue(hash, ironThreshold);
+      Hash::AddValue(hash, ironScale);
+      Hash::AddValue(hash, ironSpacing);
+      break;
+    case GenerationStage::STRUCTURES:
+    case GenerationStage::COUNT:
+      break;
+  }
+
+  return hash;
+}
+
+uint64_t DebugSettings::GetTerrainSettingsHash() const {
+  uint64_t hash = Hash::FNV_OFFSET_BASIS;
+  for (int i = 0; i < (int)GenerationStage::COUNT; i++) {
+    Hash::AddValue(hash, GetGenerationStageHash((GenerationStage)i));
+  }
+  return hash;
+}
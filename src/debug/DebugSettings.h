@@ -1,6 +1,10 @@
 #pragma once
 
+#include <string>
+#include <cstdint>
+
 #include "util/Color.h"
+#include "../world/generation/GenerationStage.h"
 
 class DebugSettings {
 public:
@@ -9,36 +13,70 @@ public:
   float defaultFOV = 90.0f;
 
   bool smoothLighting = true;
+  // lights are sampled from a volume per subchunk instead of being baked into the meshes, so light changes only upload
+  // the volumes again (about 23 KB of video memory per non-empty subchunk)
+  bool useLightVolumes = false;
 
   // world updating settings
   bool updateWorld = true;
   int renderDistance = 16;
   int inMemoryBorder = 8;
   int terrainWorkerCount = 4;
-  int lightingWorkerCount = 1;
+  int lightingWorkerCount = 4;
   int meshWorkerCount = 4;
+  int maxChunkUnloadsPerFrame = 16;
+  // chunks are generated in parallel slabs while fewer than this many wait for terrain (0 disables it)
+  int parallelGenerationQueueDepth = 4;
+
+  // far terrain settings, beyond the render distance the terrain is drawn from the heightmap alone (0 disables it)
+  int lodDistance = 64;
+  int lodWorkerCount = 1;
+  // the farthest tiles are left out once their meshes would use more than this
+  int lodMemoryBudgetMB = 128;
+  int maxLodUploadsPerFrame = 32;
+
+  // world saving settings (applied when the world is restarted)
+  bool saveWorld = true;
+  std::string saveDirectory = "saves/world";
+  // chunks with more edits than this are saved as full snapshots instead of edit logs
+  int maxChunkEditLogSize = 512;
+
+  // generated chunks are cached per seed and terrain settings, so revisiting them skips generation and lighting
+  bool useTerrainCache = true;
+  std::string terrainCacheDirectory = "cache/terrain";
+
+  // linked shader programs are cached per driver, so startup and shader reloads skip compiling unchanged shaders
+  bool useShaderCache = true;
+  std::string shaderCacheDirectory = "cache/shaders";
+  // the block atlas is loaded from this file while the block textures don't change (empty disables it)
+  std::string blockAtlasCacheFile = "cache/textures/blocks.atlas";
 
   // world visualization changes
   bool showChunkBoundaries = true;
   bool showPlayerHitbox = false;
 
   // terrain generation settings
+  int seed = 0;
   double noiseScale = 100.0;
   int octaves = 5;
   double persistence = 0.6;
   double lacunarity = 1.8;
   float noiseOffsets[2] = { 0.0, 0.0 };
 
+  // the 3D noises are sampled every `spacing` blocks and interpolated in between (1 samples every block)
   double coalThreshold = 0.15;
   double coalScale = 10.0;
+  int coalSpacing = 2;
 
   double ironThreshold = 0.15;
   double ironScale = 10.0;
+  int ironSpacing = 2;
 
   // cave settings
   double caveNoiseScale = 30.0;
   double caveThreshold = 0.25;
   float caveNoiseOffsets[3] = { 0.0, 0.0, 0.0 };
+  int caveSpacing = 4;
 
   int baseTerrainHeight = 60;
   int terrainRange[2] = { -10, 80 };
@@ -52,6 +90,11 @@ public:
   double walkSpeed = 2.5;
   double sprintMultiplier = 2.0;
 
+  // Changes whenever a setting used by the given generation stage changes
+  uint64_t GetGenerationStageHash(GenerationStage stage) const;
+  // Changes whenever a setting that affects the generated terrain changes
+  uint64_t GetTerrainSettingsHash() const;
+
   DebugSettings() = default;
   static DebugSettings instance;
 };
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "DebugShapes.h"
 
 #include "../engine/rendering/Shader.h"
+#include "../engine/rendering/meshes/LineMesh.h"
 #include "../engine/rendering/ShaderLibrary.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include "util/Logging.h"
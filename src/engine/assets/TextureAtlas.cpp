@@ -1,11 +1,7 @@
 #include "TextureAtlas.h"
 
-TextureAtlas::TextureAtlas(Texture& texture, const std::unordered_map<std::string, TextureLocation>& textureMap)
-  : m_texture(std::move(texture)), m_textureMap(std::move(textureMap)) {}
-
-void TextureAtlas::Use(unsigned int slot) const {
-  m_texture->Use(slot);
-}
+TextureAtlas::TextureAtlas(int size, std::vector<unsigned char> pixels, std::unordered_map<std::string, TextureLocation> textureMap)
+  : m_size(size), m_pixels(std::move(pixels)), m_textureMap(std::move(textureMap)) {}
 
 TextureAtlas::TextureCoords TextureAtlas::GetTextureCoords(const std::string& textureName) const {
 
@@ -25,3 +21,11 @@ TextureAtlas::TextureCoords TextureAtlas::GetTextureCoords(const std::string& te
 
   return coords;
 }
+
+int TextureAtlas::GetSize() const {
+  return m_size;
+}
+
+const std::vector<unsigned char>& TextureAtlas::GetPixels() const {
+  return m_pixels;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <unordered_map>
+#include <string>
+#include <vector>
+#include <glm/vec2.hpp>
+
+// Textures packed into one square RGBA image, and where each of them is. The renderer makes its own texture from the
+// pixels, so meshes can be built without a graphics context
+class TextureAtlas {
+public:
+
+  struct TextureLocation {
+    glm::vec2 pos;
+    float size;
+  };
+
+  struct TextureCoords {
+    float x0, y0, x1, y1;
+  };
+
+  TextureAtlas() = default;
+  TextureAtlas(int size, std::vector<unsigned char> pixels, std::unordered_map<std::string, TextureLocation> textureMap);
+
+  TextureCoords GetTextureCoords(const std::string& textureName) const;
+  // Width and height in pixels
+  int GetSize() const;
+  // Rows from the bottom up
+  const std::vector<unsigned char>& GetPixels() const;
+
+private:
+  int m_size = 0;
+  std::vector<unsigned char> m_pixels;
+  std::unordered_map<std::string, TextureLocation> m_textureMap;
+
+};
@@ -0,0 +1,208 @@
+#include "TextureAtlasBuilder.h"
+
+#include <stb/stb_image.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "util/MathUtil.h"
+#include "util/Logging.h"
+#include "util/FileUtil.h"
+#include "util/Hash.h"
+#include "util/MappedFile.h"
+#include "util/threadsafe/TaskPool.h"
+
+namespace {
+
+const int TEXTURE_SIZE = 16;
+
+// Bump when the cache layout or the atlas layout changes
+const uint32_t ATLAS_CACHE_VERSION = 1;
+const uint32_t ATLAS_CACHE_MAGIC = 0x4143434C; // "LCCA"
+
+struct AtlasCacheHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t key;
+  uint32_t atlasSize;
+  uint32_t nameCount;
+};
+
+// Tiles are laid out row by row from the top left, the names are in tile order
+std::unique_ptr<TextureAtlas> MakeAtlas(int atlasSize, std::vector<unsigned char> pixels, const std::vector<std::string>& names) {
+  // Create the coordinates mapping
+  int texturesPerRow = atlasSize / TEXTURE_SIZE;
+  float size = 1.0f / texturesPerRow;
+  std::unordered_map<std::string, TextureAtlas::TextureLocation> textureMapping;
+
+  for (int i = 0; i < (int)names.size(); i++) {
+    int row = i / texturesPerRow;
+    int col = i % texturesPerRow;
+
+    float x0 = col * size;
+    float y0 = 1.0f - ((row + 1) * size);
+
+    textureMapping[names[i]] = { {x0,y0}, size };
+  }
+
+  return std::make_unique<TextureAtlas>(atlasSize, std::move(pixels), std::move(textureMapping));
+}
+
+} // namespace
+
+TextureAtlasBuilder::TextureAtlasBuilder() {
+  AddImageFile("error");
+}
+
+void TextureAtlasBuilder::AddImageFile(const std::string& fileName, const std::string& extension) {
+  std::string filePath = std::string(RESOURCES_PATH) + "textures/" + fileName + extension;
+  m_images.push_back({ 0, fileName, {}, filePath });
+}
+
+void TextureAtlasBuilder::AddImageBytes(const std::string& imageName, std::vector<unsigned char> bytes, int size) {
+  m_images.push_back({ size, imageName, std::move(bytes), "" });
+}
+
+void TextureAtlasBuilder::SetCacheFile(const std::string& path) {
+  m_cacheFile = path;
+}
+
+// TODO: Support different sized textures if ever needed
+std::unique_ptr<TextureAtlas> TextureAtlasBuilder::Build() const {
+  uint64_t cacheKey = 0;
+  if (!m_cacheFile.empty()) {
+    cacheKey = GetCacheKey();
+    if (std::unique_ptr<TextureAtlas> atlas = LoadCache(cacheKey)) return atlas;
+  }
+
+  // Decode the files on every core, each into its own image
+  std::vector<Image> images = m_images;
+  stbi_set_flip_vertically_on_load(true);
+  TaskPool::GetInstance().ParallelFor(images.size(), [&](int i) {
+    Image& image = images[i];
+    if (image.filePath.empty()) return;
+
+    int width, height, channels;
+    unsigned char* bytes = stbi_load(image.filePath.c_str(), &width, &height, &channels, 4);
+    if (bytes == nullptr) {
+      LOG(ERROR) << "Failed to find image: " << image.name;
+      return;
+    }
+
+    if (width != height || !MathUtil::IsPowerOf2(width) || width < TEXTURE_SIZE) {
+      LOG(ERROR) << "Image dimensions for: " << image.name << " are not valid";
+    } else {
+      image.size = width;
+      image.bytes.assign(bytes, bytes + width * height * 4);
+    }
+    stbi_image_free(bytes);
+  });
+
+  // Images that failed to load don't get a tile
+  std::vector<const Image*> tiles;
+  std::vector<std::string> names;
+  for (const Image& image : images) {
+    if (image.bytes.empty()) continue;
+    tiles.push_back(&image);
+    names.push_back(image.name);
+  }
+
+  // Create the texture by combining the different images
+  int minRequiredSize = std::ceil(std::sqrt((float)tiles.size())) * TEXTURE_SIZE;
+  int textureMapSize = MathUtil::NearestPowerOf2(minRequiredSize);
+  int texturesPerRow = textureMapSize / TEXTURE_SIZE;
+
+  std::vector<unsigned char> textureAtlasBytes(textureMapSize * textureMapSize * 4, 0);
+  const int ROW_SIZE = TEXTURE_SIZE * 4;
+  for (int i = 0; i < (int)tiles.size(); i++) {
+    // The images are flipped vertically, so the first row of tiles is at the end of the atlas
+    int x0 = (i % texturesPerRow) * TEXTURE_SIZE;
+    int y0 = textureMapSize - (i / texturesPerRow + 1) * TEXTURE_SIZE;
+
+    const Image& image = *tiles[i];
+    for (int y = 0; y < TEXTURE_SIZE; y++) {
+      std::memcpy(&textureAtlasBytes[(x0 + (y0 + y) * textureMapSize) * 4], &image.bytes[y * image.size * 4], ROW_SIZE);
+    }
+  }
+
+  if (!m_cacheFile.empty()) SaveCache(cacheKey, textureMapSize, textureAtlasBytes, names);
+  return MakeAtlas(textureMapSize, std::move(textureAtlasBytes), names);
+}
+
+uint64_t TextureAtlasBuilder::GetCacheKey() const {
+  uint64_t key = Hash::FNV_OFFSET_BASIS;
+  Hash::AddValue(key, ATLAS_CACHE_VERSION);
+
+  for (const Image& image : m_images) {
+    Hash::AddString(key, image.name);
+    Hash::AddString(key, image.filePath);
+
+    if (image.filePath.empty()) {
+      Hash::AddValue(key, image.size);
+      Hash::AddBytes(key, image.bytes.data(), image.bytes.size());
+      continue;
+    }
+
+    // Cheaper than reading the files, an edited image gets a new modification time
+    std::error_code error;
+    uintmax_t fileSize = std::filesystem::file_size(image.filePath, error);
+    int64_t modified = std::filesystem::last_write_time(image.filePath, error).time_since_epoch().count();
+    if (error) {
+      fileSize = 0;
+      modified = 0;
+    }
+    Hash::AddValue(key, fileSize);
+    Hash::AddValue(key, modified);
+  }
+  return key;
+}
+
+std::unique_ptr<TextureAtlas> TextureAtlasBuilder::LoadCache(uint64_t key) const {
+  std::optional<MappedFile> file = MappedFile::Open(m_cacheFile);
+  if (!file.has_value() || file->GetSize() < sizeof(AtlasCacheHeader)) return nullptr;
+
+  const unsigned char* data = file->GetData();
+  const unsigned char* end = data + file->GetSize();
+
+  AtlasCacheHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  data += sizeof(header);
+  if (header.magic != ATLAS_CACHE_MAGIC || header.version != ATLAS_CACHE_VERSION || header.key != key) return nullptr;
+
+  std::vector<std::string> names(header.nameCount);
+  for (std::string& name : names) {
+    uint32_t length;
+    if (end - data < (ptrdiff_t)sizeof(length)) return nullptr;
+    std::memcpy(&length, data, sizeof(length));
+    data += sizeof(length);
+
+    if (end - data < (ptrdiff_t)length) return nullptr;
+    name.assign(reinterpret_cast<const char*>(data), length);
+    data += length;
+  }
+
+  size_t pixelsSize = (size_t)header.atlasSize * header.atlasSize * 4;
+  if ((size_t)(end - data) != pixelsSize) return nullptr;
+
+  return MakeAtlas(header.atlasSize, std::vector<unsigned char>(data, end), names);
+}
+
+void TextureAtlasBuilder::SaveCache(uint64_t key, int atlasSize, const std::vector<unsigned char>& pixels, const std::vector<std::string>& names) const {
+  std::error_code error;
+  std::filesystem::path parent = std::filesystem::path(m_cacheFile).parent_path();
+  if (!parent.empty()) std::filesystem::create_directories(parent, error);
+  if (error) {
+    LOG(ERROR) << "Failed to create texture cache directory " << parent.string() << ": " << error.message();
+    return;
+  }
+
+  AtlasCacheHeader header = { ATLAS_CACHE_MAGIC, ATLAS_CACHE_VERSION, key, (uint32_t)atlasSize, (uint32_t)names.size() };
+  std::ofstream file(m_cacheFile, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (const std::string& name : names) {
+    uint32_t length = name.size();
+    file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    file.write(name.data(), length);
+  }
+  // A partly written file fails the size check on the next load and is made again
+  file.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <memory>
+#include "TextureAtlas.h"
+
+class TextureAtlasBuilder {
+public:
+  TextureAtlasBuilder();
+
+  // Files are only decoded by Build, all of them at once
+  void AddImageFile(const std::string& fileName, const std::string& extension = ".png");
+  void AddImageBytes(const std::string& imageName, std::vector<unsigned char> bytes, int size);
+  // The built atlas is stored in the file, and later builds load it from there while the images stay the same
+  void SetCacheFile(const std::string& path);
+
+  std::unique_ptr<TextureAtlas> Build() const;
+
+private:
+
+  struct Image {
+    int size;
+    std::string name;
+    std::vector<unsigned char> bytes;
+    // Empty for images added as bytes
+    std::string filePath;
+  };
+
+  std::vector<Image> m_images;
+  std::string m_cacheFile;
+
+  // Changes whenever an image is added, renamed or modified on disk
+  uint64_t GetCacheKey() const;
+  std::unique_ptr<TextureAtlas> LoadCache(uint64_t key) const;
+  void SaveCache(uint64_t key, int atlasSize, const std::vector<unsigned char>& pixels, const std::vector<std::string>& names) const;
+};
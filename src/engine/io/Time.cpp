@@ -1,6 +1,5 @@
-#include <glad/glad.h>
-#include <GLFW/glfw3.h>
 #include <deque>
+#include <chrono>
 
 #include "Time.h"
 
@@ -8,6 +7,11 @@ namespace {
 const double STANDARD_DELTA = 1.0 / 120.0;
 const double MAX_DELTA = 0.1;
 
+// Seconds on a steady clock, unlike glfwGetTime it works without a window
+double GetTime() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 // Variables for FPS calculation
 std::deque<double> frameTimes; // Stores the delta times for averaging
 const size_t MAX_FRAMES = 100; // Number of frames to average over
@@ -23,12 +27,12 @@ const int& Time::averageFPS = Time::s_averageFPS_;
 const int& Time::rawFPS = Time::s_rawFPS_;
 
 void Time::Start() {
-  s_prevTime_ = glfwGetTime() - STANDARD_DELTA;
+  s_prevTime_ = GetTime() - STANDARD_DELTA;
   s_deltaTime_ = STANDARD_DELTA;
 }
 
 void Time::Update() {
-  double currTime = glfwGetTime();
+  double currTime = GetTime();
   double rawDeltaTime = currTime - s_prevTime_;
 
   // Clamp the delta to reduce spikes (not sure if this is a good thing to do)
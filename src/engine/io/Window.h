@@ -4,6 +4,7 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <optional>
+#include <string>
 #include <glm/vec2.hpp>
 #include <vector>
 #include <functional>
@@ -0,0 +1,108 @@
+#include "ProgramBinaryCache.h"
+
+#include <glad/glad.h>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "util/Logging.h"
+#include "util/Hash.h"
+
+namespace {
+
+// Bump when the file layout changes
+const uint32_t PROGRAM_BINARY_VERSION = 1;
+const uint32_t PROGRAM_BINARY_MAGIC = 0x4250434C; // "LCPB"
+
+struct ProgramBinaryHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t sourceHash;
+  uint64_t driverHash;
+  uint32_t format;
+  uint32_t length;
+};
+
+std::string GetGLString(GLenum name) {
+  const GLubyte* value = glGetString(name);
+  return value != nullptr ? reinterpret_cast<const char*>(value) : "";
+}
+
+} // namespace
+
+ProgramBinaryCache::ProgramBinaryCache(const std::string& directory)
+  : m_directory(directory), m_driverHash(Hash::FNV_OFFSET_BASIS) {
+  // A driver update can change the binaries without changing the formats
+  Hash::AddString(m_driverHash, GetGLString(GL_VENDOR));
+  Hash::AddString(m_driverHash, GetGLString(GL_RENDERER));
+  Hash::AddString(m_driverHash, GetGLString(GL_VERSION));
+}
+
+bool ProgramBinaryCache::IsSupported() {
+  // Only core since 4.1, the function is missing on older contexts
+  if (glGetProgramBinary == nullptr || glProgramBinary == nullptr) return false;
+
+  int formatCount = 0;
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+  return formatCount > 0;
+}
+
+uint64_t ProgramBinaryCache::HashSources(const std::string& vertexSource, const std::string& fragmentSource) {
+  uint64_t hash = Hash::FNV_OFFSET_BASIS;
+  Hash::AddString(hash, vertexSource);
+  Hash::AddString(hash, fragmentSource);
+  return hash;
+}
+
+bool ProgramBinaryCache::Load(const std::string& name, uint64_t sourceHash, unsigned int program) const {
+  std::ifstream file(GetPath(name), std::ios::binary);
+  if (!file.is_open()) return false;
+
+  ProgramBinaryHeader header;
+  if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+  if (header.magic != PROGRAM_BINARY_MAGIC || header.version != PROGRAM_BINARY_VERSION ||
+    header.sourceHash != sourceHash || header.driverHash != m_driverHash) {
+    return false;
+  }
+
+  std::vector<char> binary(header.length);
+  if (!file.read(binary.data(), binary.size())) return false;
+
+  glProgramBinary(program, header.format, binary.data(), binary.size());
+
+  // Drivers may still refuse binaries they made, e.g. after a setting changed
+  int success;
+  glGetProgramiv(program, GL_LINK_STATUS, &success);
+  return success;
+}
+
+void ProgramBinaryCache::Save(const std::string& name, uint64_t sourceHash, unsigned int program) const {
+  int length = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) return;
+
+  ProgramBinaryHeader header = { PROGRAM_BINARY_MAGIC, PROGRAM_BINARY_VERSION, sourceHash, m_driverHash, 0, 0 };
+  std::vector<char> binary(length);
+  GLsizei written = 0;
+  GLenum format = 0;
+  glGetProgramBinary(program, length, &written, &format, binary.data());
+  if (written <= 0) return;
+  header.format = format;
+  header.length = written;
+
+  std::error_code error;
+  std::filesystem::create_directories(m_directory, error);
+  if (error) {
+    LOG(ERROR) << "Failed to create shader cache directory " << m_directory << ": " << error.message();
+    return;
+  }
+
+  // A partly written file fails the length check on the next load and is made again
+  std::ofstream file(GetPath(name), std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(binary.data(), written);
+}
+
+std::string ProgramBinaryCache::GetPath(const std::string& name) const {
+  return (std::filesystem::path(m_directory) / (name + ".bin")).string();
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+// Linked programs stored on disk as driver binaries, so later runs skip compiling shaders whose sources didn't change.
+// A binary is only used by the driver that made it, anything else falls back to compiling the sources
+class ProgramBinaryCache {
+public:
+  // Needs a current context, to tell which driver the binaries are for
+  explicit ProgramBinaryCache(const std::string& directory);
+
+  // Whether the driver hands out program binaries at all
+  static bool IsSupported();
+  static uint64_t HashSources(const std::string& vertexSource, const std::string& fragmentSource);
+
+  // Loads the cached binary into the program, returns false if there is none for these sources and this driver or
+  // the driver doesn't accept it anymore
+  bool Load(const std::string& name, uint64_t sourceHash, unsigned int program) const;
+  // The program has to be linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set
+  void Save(const std::string& name, uint64_t sourceHash, unsigned int program) const;
+
+private:
+  std::string m_directory;
+  uint64_t m_driverHash;
+
+  std::string GetPath(const std::string& name) const;
+};
@@ -3,7 +3,9 @@
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
+#include <unordered_map>
 
+#include "ProgramBinaryCache.h"
 #include "util/FileUtil.h"
 #include "util/Logging.h"
 
@@ -14,13 +16,17 @@ enum ShaderType {
   FRAGMENT
 };
 
+// Only starts the compilation, drivers that compile in the background keep going until the status is asked for
 unsigned int CompileShaderSource(const char* source, ShaderType shaderType) {
   unsigned int shader;
   GLuint glShaderType = shaderType == VERTEX ? GL_VERTEX_SHADER : GL_FRAGMENT_SHADER;
   shader = glCreateShader(glShaderType);
   glShaderSource(shader, 1, &source, NULL);
   glCompileShader(shader);
+  return shader;
+}
 
+void CheckCompileStatus(unsigned int shader) {
   int success;
   char infoLog[512];
   glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
@@ -28,41 +34,109 @@ unsigned int CompileShaderSource(const char* source, ShaderType shaderType) {
     glGetShaderInfoLog(shader, 512, NULL, infoLog);
     LOG(ERROR) << "SHADER COMPILATION ERROR:\n" << infoLog << '\n';
   }
+}
 
-  return shader;
+// The defines have to come after the #version line
+std::string AddDefines(const std::string& source, const std::vector<std::string>& defines) {
+  if (defines.empty()) return source;
+
+  std::string lines;
+  for (const std::string& define : defines) {
+    lines += "#define " + define + "\n";
+  }
+
+  size_t lineEnd = source.find('\n');
+  if (lineEnd == std::string::npos) return source + "\n" + lines;
+  return source.substr(0, lineEnd + 1) + lines + source.substr(lineEnd + 1);
+}
+
+// Lookups that haven't been made yet, a missing uniform is -1
+const int UNKNOWN_LOCATION = -2;
+
+// Only used by the render thread and static initializers
+struct UniformRegistry {
+  std::unordered_map<std::string, Shader::UniformId> ids;
+  std::vector<std::string> names;
+};
+
+UniformRegistry& GetUniformRegistry() {
+  static UniformRegistry registry;
+  return registry;
 }
 
 } // namespace
 
+const unsigned int Shader::CAMERA_BLOCK_BINDING = 0;
+
+Shader::UniformId Shader::GetUniformId(const std::string& uniform) {
+  UniformRegistry& registry = GetUniformRegistry();
+  auto [it, inserted] = registry.ids.try_emplace(uniform, (UniformId)registry.names.size());
+  if (inserted) registry.names.push_back(uniform);
+  return it->second;
+}
+
 Shader::Shader(const std::string& shaderName)
   : Shader(shaderName, shaderName) {}
 
-Shader::Shader(const std::string& vertexShaderName, const std::string& fragmentShaderName) {
-  std::string vertexSourceCode = FileUtil::ReadSource("shaders/" + vertexShaderName + ".vert");
-  std::string fragmentSourceCode = FileUtil::ReadSource("shaders/" + fragmentShaderName + ".frag");
+Shader::Shader(const std::string& vertexShaderName, const std::string& fragmentShaderName)
+  : Shader(vertexShaderName, fragmentShaderName, {}) {}
+
+Shader::Shader(const std::string& vertexShaderName, const std::string& fragmentShaderName, const std::vector<std::string>& defines)
+  : Shader(vertexShaderName, fragmentShaderName, defines, nullptr, "") {}
+
+Shader::Shader(const std::string& vertexShaderName, const std::string& fragmentShaderName, const std::vector<std::string>& defines,
+  const ProgramBinaryCache* cache, const std::string& cacheName)
+  : m_name(vertexShaderName + ".vert/" + fragmentShaderName + ".frag"), m_cache(cache), m_cacheName(cacheName) {
+  std::string vertexSourceCode = AddDefines(FileUtil::ReadSource("shaders/" + vertexShaderName + ".vert"), defines);
+  std::string fragmentSourceCode = AddDefines(FileUtil::ReadSource("shaders/" + fragmentShaderName + ".frag"), defines);
+
+  m_shaderProgram = glCreateProgram();
+  if (m_cache != nullptr) {
+    m_sourceHash = ProgramBinaryCache::HashSources(vertexSourceCode, fragmentSourceCode);
+    if (m_cache->Load(m_cacheName, m_sourceHash, m_shaderProgram)) {
+      BindUniformBlocks();
+      return;
+    }
+
+    // Start over from a clean program, the refused binary left this one unlinked
+    glDeleteProgram(m_shaderProgram);
+    m_shaderProgram = glCreateProgram();
+    glProgramParameteri(m_shaderProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+  }
 
   const char* vertexSource = vertexSourceCode.c_str();
   const char* fragmentSource = fragmentSourceCode.c_str();
 
-  unsigned int vertexShader = CompileShaderSource(vertexSource, VERTEX);
-  unsigned int fragmentShader = CompileShaderSource(fragmentSource, FRAGMENT);
+  m_vertexShader = CompileShaderSource(vertexSource, VERTEX);
+  m_fragmentShader = CompileShaderSource(fragmentSource, FRAGMENT);
 
-  // Link the shaders into a program
-  m_shaderProgram = glCreateProgram();
-  glAttachShader(m_shaderProgram, vertexShader);
-  glAttachShader(m_shaderProgram, fragmentShader);
+  // Link the shaders into a program, the result is checked by FinishLinking
+  glAttachShader(m_shaderProgram, m_vertexShader);
+  glAttachShader(m_shaderProgram, m_fragmentShader);
   glLinkProgram(m_shaderProgram);
+  m_linkPending = true;
+}
+
+void Shader::FinishLinking() {
+  if (!m_linkPending) return;
+  m_linkPending = false;
+
+  CheckCompileStatus(m_vertexShader);
+  CheckCompileStatus(m_fragmentShader);
 
   int success;
   char infoLog[512];
   glGetProgramiv(m_shaderProgram, GL_LINK_STATUS, &success);
   if (!success) {
     glGetProgramInfoLog(m_shaderProgram, 512, NULL, infoLog);
-    LOG(ERROR) << "FAILED TO LINK SHADER (" << vertexShaderName << ".vert/" << fragmentShaderName << ".frag):\n" << infoLog << '\n';
+    LOG(ERROR) << "FAILED TO LINK SHADER (" << m_name << "):\n" << infoLog << '\n';
   }
 
-  glDeleteShader(vertexShader);
-  glDeleteShader(fragmentShader);
+  glDeleteShader(m_vertexShader);
+  glDeleteShader(m_fragmentShader);
+
+  if (success && m_cache != nullptr) m_cache->Save(m_cacheName, m_sourceHash, m_shaderProgram);
+  BindUniformBlocks();
 }
 
 Shader::~Shader() {
@@ -76,39 +150,63 @@ void Shader::Use() const {
 }
 
 void Shader::LoadMatrix4f(const std::string& uniform, const glm::mat4& matrix) {
-  unsigned int location = GetUniformLocation(uniform);
+  int location = GetUniformLocation(uniform);
   glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
 }
 
 void Shader::LoadVector4f(const std::string& uniform, const glm::vec4& vec) {
-  unsigned int location = GetUniformLocation(uniform);
+  int location = GetUniformLocation(uniform);
   glUniform4fv(location, 1, glm::value_ptr(vec));
 }
 
 void Shader::LoadVector3f(const std::string& uniform, const glm::vec3& vec) {
-  unsigned int location = GetUniformLocation(uniform);
+  int location = GetUniformLocation(uniform);
   glUniform3fv(location, 1, glm::value_ptr(vec));
 }
 
 void Shader::LoadVector2f(const std::string& uniform, const glm::vec2& vec) {
-  unsigned int location = GetUniformLocation(uniform);
+  int location = GetUniformLocation(uniform);
   glUniform2fv(location, 1, glm::value_ptr(vec));
 }
 
 void Shader::LoadInt(const std::string& uniform, int value) {
-  unsigned int location = GetUniformLocation(uniform);
+  int location = GetUniformLocation(uniform);
   glUniform1i(location, value);
 }
 
 void Shader::LoadBool(const std::string& uniform, bool value) {
-  unsigned int location = GetUniformLocation(uniform);
+  int location = GetUniformLocation(uniform);
   glUniform1i(location, value);
 }
 
-unsigned int Shader::GetUniformLocation(const std::string& uniform) {
-  if (m_uniformMap.find(uniform) == m_uniformMap.end()) {
-    unsigned int location = glGetUniformLocation(m_shaderProgram, uniform.c_str());
-    m_uniformMap[uniform] = location;
+void Shader::LoadMatrix4f(UniformId uniform, const glm::mat4& matrix) {
+  glUniformMatrix4fv(GetUniformLocation(uniform), 1, GL_FALSE, glm::value_ptr(matrix));
+}
+
+void Shader::LoadBool(UniformId uniform, bool value) {
+  glUniform1i(GetUniformLocation(uniform), value);
+}
+
+int Shader::GetUniformLocation(const std::string& uniform) {
+  return GetUniformLocation(GetUniformId(uniform));
+}
+
+int Shader::GetUniformLocation(UniformId uniform) {
+  if (uniform >= (int)m_uniformLocations.size()) {
+    m_uniformLocations.resize(uniform + 1, UNKNOWN_LOCATION);
+  }
+
+  int& location = m_uniformLocations[uniform];
+  if (location == UNKNOWN_LOCATION) {
+    location = glGetUniformLocation(m_shaderProgram, GetUniformRegistry().names[uniform].c_str());
+  }
+  return location;
+}
+
+void Shader::BindUniformBlocks() {
+  // GLSL 330 can't pick the binding point in the shader itself
+  unsigned int cameraBlock = glGetUniformBlockIndex(m_shaderProgram, "Camera");
+  if (cameraBlock != GL_INVALID_INDEX) {
+    glUniformBlockBinding(m_shaderProgram, cameraBlock, CAMERA_BLOCK_BINDING);
   }
-  return m_uniformMap[uniform];
 }
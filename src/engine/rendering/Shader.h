@@ -2,19 +2,39 @@
 
 #include <string>
 #include <glm/mat4x4.hpp>
-#include <unordered_map>
+#include <vector>
+#include <cstdint>
 
 #include "util/ClassMacros.h"
 
+class ProgramBinaryCache;
+
 class Shader {
 
 public:
+  // Handle of a uniform name, the same in every program. Fetch it once (into a static) so draw loops load uniforms
+  // without hashing their names
+  using UniformId = int;
+  static UniformId GetUniformId(const std::string& uniform);
+
+  // Binding point of the Camera uniform block, see ShaderLibrary::SetCamera
+  static const unsigned int CAMERA_BLOCK_BINDING;
+
   explicit Shader(const std::string& shaderName);
   Shader(const std::string& vertexShaderName, const std::string& fragmentShaderName);
+  // Compiles the sources with a #define for each of the given names, so one source can make several variants
+  Shader(const std::string& vertexShaderName, const std::string& fragmentShaderName, const std::vector<std::string>& defines);
+  // Programs found in the cache under `cacheName` skip compiling, the others are stored there once linked
+  Shader(const std::string& vertexShaderName, const std::string& fragmentShaderName, const std::vector<std::string>& defines,
+    const ProgramBinaryCache* cache, const std::string& cacheName);
   ~Shader();
 
   ONLY_MOVE_ID(Shader, m_shaderProgram);
 
+  // Compiling and linking only start in the constructor, so several programs can be built at once.
+  // This waits for the result and has to be called before the program is used
+  void FinishLinking();
+
   void Use() const;
 
   void LoadMatrix4f(const std::string& uniform, const glm::mat4& matrix);
@@ -24,9 +44,25 @@ public:
   void LoadInt(const std::string& uniform, int value);
   void LoadBool(const std::string& uniform, bool value);
 
+  void LoadMatrix4f(UniformId uniform, const glm::mat4& matrix);
+  void LoadBool(UniformId uniform, bool value);
+
 private:
   unsigned int m_shaderProgram;
-  std::unordered_map<std::string, unsigned int> m_uniformMap;
+  std::string m_name;
+
+  // Only set while the link started by the constructor hasn't been checked
+  bool m_linkPending = false;
+  unsigned int m_vertexShader = 0;
+  unsigned int m_fragmentShader = 0;
+
+  const ProgramBinaryCache* m_cache;
+  std::string m_cacheName;
+  uint64_t m_sourceHash = 0;
+  // Locations by uniform id, filled in the first time each id is used
+  std::vector<int> m_uniformLocations;
 
-  unsigned int GetUniformLocation(const std::string& uniform);
+  int GetUniformLocation(const std::string& uniform);
+  int GetUniformLocation(UniformId uniform);
+  void BindUniformBlocks();
 };
\ No newline at end of file
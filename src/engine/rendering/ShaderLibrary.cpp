@@ -1,19 +1,46 @@
 #include "ShaderLibrary.h"
 #include "util/Logging.h"
 
+#include <cstddef>
+#include <chrono>
+
 ShaderLibrary& ShaderLibrary::GetInstance() {
   static ShaderLibrary shaderLibrary;
   return shaderLibrary;
 }
 
 void ShaderLibrary::LoadShaders() {
+  if (m_cameraBuffer == nullptr) {
+    m_cameraBuffer = std::make_unique<UniformBuffer>(sizeof(CameraUniforms), Shader::CAMERA_BLOCK_BINDING);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  m_binaryCache.reset();
+  if (!m_binaryCacheDirectory.empty() && ProgramBinaryCache::IsSupported()) {
+    m_binaryCache = std::make_unique<ProgramBinaryCache>(m_binaryCacheDirectory);
+  }
+
   // This function must contain all the shaders used
   Load("main");
+  // Chunk faces with see-through pixels, the opaque ones skip the discard so early depth testing stays on
+  LoadVariant("main_cutout", "main", { "ALPHA_CUTOUT" });
   Load("line");
   Load("colored_lines");
   Load("shape");
   Load("textured_ui");
   Load("colored_ui");
+
+  // Every program was handed to the driver before waiting on any, so they can compile at the same time
+  for (auto& [_, shader] : m_shaders) {
+    shader->FinishLinking();
+  }
+
+  double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  LOG(INFO) << "Loaded " << m_shaders.size() << " shaders in " << milliseconds << " ms" << (m_binaryCache ? "" : " (no binary cache)");
+}
+
+void ShaderLibrary::SetBinaryCacheDirectory(const std::string& directory) {
+  m_binaryCacheDirectory = directory;
 }
 
 void ShaderLibrary::ReloadShaders() {
@@ -37,13 +64,17 @@ Shader& ShaderLibrary::Get(const std::string& name) const {
 
 void ShaderLibrary::Clear() {
   m_shaders.clear();
+  m_cameraBuffer.reset();
 }
 
-void ShaderLibrary::LoadMatrix4f(const std::string& uniform, glm::mat4 matrix) {
-  for (auto& [_, shader] : m_shaders) {
-    shader->Use();
-    shader->LoadMatrix4f(uniform, matrix);
-  }
+void ShaderLibrary::SetCamera(const glm::mat4& projection, const glm::mat4& view) {
+  // projection and view are next to each other, so both go in one upload
+  const glm::mat4 matrices[2] = { projection, view };
+  m_cameraBuffer->SetSubData(matrices, offsetof(CameraUniforms, projection), sizeof(matrices));
+}
+
+void ShaderLibrary::SetProjection2D(const glm::mat4& projection2D) {
+  m_cameraBuffer->SetSubData(&projection2D, offsetof(CameraUniforms, projection2D), sizeof(glm::mat4));
 }
 
 void ShaderLibrary::LoadVector2f(const std::string& uniform, glm::vec2 vec) {
@@ -54,5 +85,9 @@ void ShaderLibrary::LoadVector2f(const std::string& uniform, glm::vec2 vec) {
 }
 
 void ShaderLibrary::Load(const std::string& name) {
-  m_shaders[name] = std::make_unique<Shader>(name);
+  LoadVariant(name, name, {});
+}
+
+void ShaderLibrary::LoadVariant(const std::string& name, const std::string& sourceName, const std::vector<std::string>& defines) {
+  m_shaders[name] = std::make_unique<Shader>(sourceName, sourceName, defines, m_binaryCache.get(), name);
 }
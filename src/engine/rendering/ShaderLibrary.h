@@ -1,8 +1,12 @@
 #pragma once
 
 #include "Shader.h"
+#include "ProgramBinaryCache.h"
+#include "buffers/UniformBuffer.h"
 #include <glm/mat4x4.hpp>
 #include <functional>
+#include <unordered_map>
+#include <memory>
 
 class ShaderLibrary {
 public:
@@ -11,11 +15,15 @@ public:
   void LoadShaders();
   void ReloadShaders();
   void OnReloadShaders(std::function<void()> callback);
+  // Linked programs are cached in the directory from the next load on, an empty directory turns the cache off
+  void SetBinaryCacheDirectory(const std::string& directory);
 
   Shader& Get(const std::string& name) const;
   void Clear();
 
-  void LoadMatrix4f(const std::string& uniform, glm::mat4 matrix);
+  // Camera matrices are kept in one uniform buffer that every program reads, so they are uploaded once per frame
+  void SetCamera(const glm::mat4& projection, const glm::mat4& view);
+  void SetProjection2D(const glm::mat4& projection2D);
   void LoadVector2f(const std::string& uniform, glm::vec2 vec);
 
 private:
@@ -23,7 +31,21 @@ private:
   ~ShaderLibrary() = default;
 
   void Load(const std::string& name);
+  // Loads a variant of the named shader compiled with the given defines
+  void LoadVariant(const std::string& name, const std::string& sourceName, const std::vector<std::string>& defines);
+
+  // Same layout as the Camera block in the shaders (std140)
+  struct CameraUniforms {
+    glm::mat4 projection;
+    glm::mat4 view;
+    glm::mat4 projection2D;
+  };
 
   std::function<void()> m_reloadCallback;
   std::unordered_map<std::string, std::unique_ptr<Shader>> m_shaders;
+  // Made with the first shaders and kept across reloads
+  std::unique_ptr<UniformBuffer> m_cameraBuffer;
+  std::string m_binaryCacheDirectory;
+  // Made again by every load, only when a directory is set and the driver supports program binaries
+  std::unique_ptr<ProgramBinaryCache> m_binaryCache;
 };
@@ -22,11 +22,16 @@ IndexBuffer::~IndexBuffer() {
   }
 }
 
-void IndexBuffer::SetData(unsigned int* indices, size_t size) const {
+void IndexBuffer::SetData(const unsigned int* indices, size_t size) const {
   Bind();
   glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, indices, GL_STATIC_DRAW);
 }
 
+void IndexBuffer::SetSubData(const unsigned int* indices, size_t offset, size_t size) const {
+  Bind();
+  glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset, size, indices);
+}
+
 void IndexBuffer::Bind() const {
   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include "util/ClassMacros.h"
 
 class IndexBuffer {
@@ -10,7 +11,9 @@ public:
   IndexBuffer(unsigned int* indices, size_t size);
   ~IndexBuffer();
 
-  void SetData(unsigned int* indices, size_t size) const;
+  void SetData(const unsigned int* indices, size_t size) const;
+  // Replaces `size` bytes from `offset` on, the buffer must already be large enough
+  void SetSubData(const unsigned int* indices, size_t offset, size_t size) const;
 
   void Bind() const;
   void Unbind() const;
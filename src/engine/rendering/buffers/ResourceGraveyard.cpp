@@ -16,6 +16,11 @@ void ResourceGraveyard::QueueVBOForDeletion(unsigned int vbo) {
   m_vbosToDelete.push_back(vbo);
 }
 
+void ResourceGraveyard::QueueTextureForDeletion(unsigned int texture) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_texturesToDelete.push_back(texture);
+}
+
 void ResourceGraveyard::Flush() {
   std::lock_guard<std::mutex> lock(m_mutex);
 
@@ -25,8 +30,12 @@ void ResourceGraveyard::Flush() {
   if (!m_vaosToDelete.empty()) {
     glDeleteVertexArrays(m_vaosToDelete.size(), m_vaosToDelete.data());
   }
+  if (!m_texturesToDelete.empty()) {
+    glDeleteTextures(m_texturesToDelete.size(), m_texturesToDelete.data());
+  }
 
   m_vbosToDelete.clear();
   m_vaosToDelete.clear();
+  m_texturesToDelete.clear();
 
 }
@@ -7,6 +7,7 @@ public:
 
   void QueueVAOForDeletion(unsigned int vao);
   void QueueVBOForDeletion(unsigned int vbo);
+  void QueueTextureForDeletion(unsigned int texture);
 
   void Flush();
 
@@ -14,4 +15,5 @@ private:
   std::mutex m_mutex;
   std::vector<unsigned int> m_vaosToDelete;
   std::vector<unsigned int> m_vbosToDelete;
+  std::vector<unsigned int> m_texturesToDelete;
 };
\ No newline at end of file
@@ -0,0 +1,27 @@
+#include <glad/glad.h>
+
+#include "UniformBuffer.h"
+#include "ResourceGraveyard.h"
+
+UniformBuffer::UniformBuffer(size_t size, unsigned int bindingPoint) {
+  glGenBuffers(1, &m_ubo);
+  Bind();
+  glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+  glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, m_ubo);
+}
+
+UniformBuffer::~UniformBuffer() {
+  if (m_ubo != 0) {
+    ResourceGraveyard::GetInstance().QueueVBOForDeletion(m_ubo);
+    m_ubo = 0;
+  }
+}
+
+void UniformBuffer::SetSubData(const void* data, size_t offset, size_t size) const {
+  Bind();
+  glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+}
+
+void UniformBuffer::Bind() const {
+  glBindBuffer(GL_UNIFORM_BUFFER, m_ubo);
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+
+#include "util/ClassMacros.h"
+
+// Uniforms shared by several programs, attached to a binding point that the programs' uniform blocks point at
+class UniformBuffer {
+public:
+  ONLY_MOVE_ID(UniformBuffer, m_ubo);
+
+  UniformBuffer(size_t size, unsigned int bindingPoint);
+  ~UniformBuffer();
+
+  // Replaces `size` bytes from `offset` on
+  void SetSubData(const void* data, size_t offset, size_t size) const;
+
+  void Bind() const;
+
+private:
+  unsigned int m_ubo;
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include "util/ClassMacros.h"
 #include <vector>
 
@@ -22,11 +22,16 @@ VertexBuffer::~VertexBuffer() {
   }
 }
 
-void VertexBuffer::SetData(float* vertices, size_t size) const {
+void VertexBuffer::SetData(const float* vertices, size_t size) const {
   Bind();
   glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
 }
 
+void VertexBuffer::SetSubData(const float* vertices, size_t offset, size_t size) const {
+  Bind();
+  glBufferSubData(GL_ARRAY_BUFFER, offset, size, vertices);
+}
+
 void VertexBuffer::Bind() const {
   glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
 }
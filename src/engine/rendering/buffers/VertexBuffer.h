@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include "util/ClassMacros.h"
 
 class VertexBuffer {
@@ -10,7 +11,9 @@ public:
   VertexBuffer(float* vertices, size_t size);
   ~VertexBuffer();
 
-  void SetData(float* vertices, size_t size) const;
+  void SetData(const float* vertices, size_t size) const;
+  // Replaces `size` bytes from `offset` on, the buffer must already be large enough
+  void SetSubData(const float* vertices, size_t offset, size_t size) const;
 
   void Bind() const;
   void Unbind() const;
@@ -1,4 +1,5 @@
 #include <glad/glad.h>
+#include <cstddef>
 #include "ColoredLinesMesh.h"
 
 void ColoredLinesMesh::Draw() const {
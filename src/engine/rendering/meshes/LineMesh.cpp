@@ -1,4 +1,5 @@
 #include <glad/glad.h>
+#include <cstddef>
 #include "LineMesh.h"
 
 void LineMesh::Draw() const {
@@ -3,17 +3,23 @@
 #include "Mesh.h"
 #include "util/Logging.h"
 
+#include <algorithm>
+
 Mesh::Mesh(Mesh&& other)
   : m_vertexArray(std::move(other.m_vertexArray)),
   m_vertexBuffer(std::move(other.m_vertexBuffer)),
   m_indexBuffer(std::move(other.m_indexBuffer)),
-  m_indexCount(other.m_indexCount) {}
+  m_indexCount(other.m_indexCount),
+  m_vertexCapacity(other.m_vertexCapacity),
+  m_indexCapacity(other.m_indexCapacity) {}
 
 Mesh& Mesh::operator=(Mesh&& other) {
   m_vertexArray = std::move(other.m_vertexArray);
   m_vertexBuffer = std::move(other.m_vertexBuffer);
   m_indexBuffer = std::move(other.m_indexBuffer);
   m_indexCount = other.m_indexCount;
+  m_vertexCapacity = other.m_vertexCapacity;
+  m_indexCapacity = other.m_indexCapacity;
 
   return *this;
 }
@@ -23,16 +29,50 @@ Mesh::Mesh()
 
 Mesh::~Mesh() {}
 
-void Mesh::SetData(float* vertices, size_t vertexCount, unsigned int* indices, size_t indexCount) {
+void Mesh::SetData(const float* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount) {
   Bind();
   m_vertexBuffer.SetData(vertices, vertexCount * sizeof(float));
   m_indexBuffer.SetData(indices, indexCount * sizeof(unsigned int));
   m_indexCount = indexCount;
+  m_vertexCapacity = vertexCount;
+  m_indexCapacity = indexCount;
 
   if (!m_hasData) SetupAttributes();
   m_hasData = true;
 }
 
+void Mesh::SetData(const float* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount,
+  size_t vertexCapacity, size_t indexCapacity) {
+  vertexCapacity = std::max(vertexCapacity, vertexCount);
+  indexCapacity = std::max(indexCapacity, indexCount);
+
+  Bind();
+  m_vertexBuffer.SetData(nullptr, vertexCapacity * sizeof(float));
+  m_vertexBuffer.SetSubData(vertices, 0, vertexCount * sizeof(float));
+  m_indexBuffer.SetData(nullptr, indexCapacity * sizeof(unsigned int));
+  m_indexBuffer.SetSubData(indices, 0, indexCount * sizeof(unsigned int));
+  m_indexCount = indexCount;
+  m_vertexCapacity = vertexCapacity;
+  m_indexCapacity = indexCapacity;
+
+  if (!m_hasData) SetupAttributes();
+  m_hasData = true;
+}
+
+bool Mesh::PatchData(const float* vertices, size_t vertexOffset, size_t vertexCount,
+  const unsigned int* indices, size_t indexOffset, size_t indexCount, size_t totalIndexCount) {
+  if (!m_hasData || vertexOffset + vertexCount > m_vertexCapacity || indexOffset + indexCount > m_indexCapacity ||
+    totalIndexCount > m_indexCapacity) {
+    return false;
+  }
+
+  Bind();
+  if (vertexCount > 0) m_vertexBuffer.SetSubData(vertices, vertexOffset * sizeof(float), vertexCount * sizeof(float));
+  if (indexCount > 0) m_indexBuffer.SetSubData(indices, indexOffset * sizeof(unsigned int), indexCount * sizeof(unsigned int));
+  m_indexCount = totalIndexCount;
+  return true;
+}
+
 void Mesh::Bind() const {
   m_vertexArray.Bind();
 }
@@ -15,7 +15,14 @@ public:
   Mesh(Mesh&& other);
   Mesh& operator=(Mesh&& other);
 
-  void SetData(float* vertices, size_t vertexCount, unsigned int* indices, size_t indexCount);
+  void SetData(const float* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount);
+  // Same as SetData, but the buffers are made large enough for the given capacities so later patches can grow the mesh
+  void SetData(const float* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount,
+    size_t vertexCapacity, size_t indexCapacity);
+  // Replaces part of the vertices and indices in place and draws `totalIndexCount` indices from then on.
+  // Returns false without changing anything if the data doesn't fit in the buffers
+  bool PatchData(const float* vertices, size_t vertexOffset, size_t vertexCount,
+    const unsigned int* indices, size_t indexOffset, size_t indexCount, size_t totalIndexCount);
   void Bind() const;
   virtual void Draw() const;
 
@@ -27,6 +34,9 @@ protected:
   IndexBuffer m_indexBuffer;
 
   unsigned int m_indexCount;
+  // Number of floats and indices the buffers have room for
+  size_t m_vertexCapacity = 0;
+  size_t m_indexCapacity = 0;
   bool m_hasData;
 
   virtual void SetupAttributes() const;
@@ -37,7 +37,7 @@ Texture::Texture(const std::string& fileName, const std::string& extension) {
   stbi_image_free(image_data);
 }
 
-Texture::Texture(int width, int height, unsigned char* imageData, int mipmapLevels) {
+Texture::Texture(int width, int height, const unsigned char* imageData, int mipmapLevels) {
   glGenTextures(1, &m_textureID);
   glBindTexture(GL_TEXTURE_2D, m_textureID);
 
@@ -9,7 +9,7 @@ class Texture {
 public:
   Texture();
   explicit Texture(const std::string& fileName, const std::string& extension = ".png");
-  Texture(int width, int height, unsigned char* imageData, int mipmapLevels = 0);
+  Texture(int width, int height, const unsigned char* imageData, int mipmapLevels = 0);
   ~Texture();
 
   DELETE_COPY(Texture);
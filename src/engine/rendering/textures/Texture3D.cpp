@@ -0,0 +1,42 @@
+#include "Texture3D.h"
+
+#include <glad/glad.h>
+#include "rendering/buffers/ResourceGraveyard.h"
+
+Texture3D::Texture3D() {
+  glGenTextures(1, &m_textureID);
+  glBindTexture(GL_TEXTURE_3D, m_textureID);
+
+  glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+}
+
+Texture3D::~Texture3D() {
+  // Volumes can be destroyed with their chunk on a worker thread
+  if (m_textureID != 0) {
+    ResourceGraveyard::GetInstance().QueueTextureForDeletion(m_textureID);
+    m_textureID = 0;
+  }
+}
+
+void Texture3D::SetData(int width, int height, int depth, const unsigned char* data) {
+  glBindTexture(GL_TEXTURE_3D, m_textureID);
+
+  if (width == m_width && height == m_height && depth == m_depth) {
+    glTexSubImage3D(GL_TEXTURE_3D, 0, 0, 0, 0, width, height, depth, GL_RGBA, GL_UNSIGNED_BYTE, data);
+    return;
+  }
+
+  glTexImage3D(GL_TEXTURE_3D, 0, GL_RGBA8, width, height, depth, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+  m_width = width;
+  m_height = height;
+  m_depth = depth;
+}
+
+void Texture3D::Use(unsigned int slot) const {
+  glActiveTexture(GL_TEXTURE0 + slot);
+  glBindTexture(GL_TEXTURE_3D, m_textureID);
+}
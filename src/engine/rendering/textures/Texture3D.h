@@ -0,0 +1,22 @@
+#pragma once
+
+#include "util/ClassMacros.h"
+
+// RGBA volume sampled with linear filtering, for data stored per cell of a grid
+class Texture3D {
+public:
+  DELETE_COPY(Texture3D);
+
+  Texture3D();
+  ~Texture3D();
+
+  // Replaces the whole volume, the storage is only reallocated when the size changes
+  void SetData(int width, int height, int depth, const unsigned char* data);
+  void Use(unsigned int slot = 0) const;
+
+private:
+  unsigned int m_textureID;
+  int m_width = 0;
+  int m_height = 0;
+  int m_depth = 0;
+};
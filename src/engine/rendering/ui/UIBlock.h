@@ -3,6 +3,7 @@
 #include <glm/vec2.hpp>
 #include <glm/vec4.hpp>
 #include <vector>
+#include <memory>
 
 enum AlignmentType { START, CENTER, END };
 enum DirectionType { HORIZONTAL, VERTICAL };
@@ -0,0 +1,73 @@
+#include "Compression.h"
+
+#include <cstring>
+#include <algorithm>
+
+namespace {
+// Control bytes 0..127 are followed by (n + 1) literal bytes
+// Control bytes 128..255 are followed by a single byte repeated (n - 125) times
+const size_t MAX_LITERAL_LENGTH = 128;
+const size_t MIN_RUN_LENGTH = 3;
+const size_t MAX_RUN_LENGTH = 130;
+} // namespace
+
+namespace Compression {
+
+void RunLengthEncode(const unsigned char* data, size_t size, std::vector<unsigned char>& output) {
+  size_t i = 0;
+  size_t literalStart = 0;
+
+  auto flushLiterals = [&](size_t end) {
+    while (literalStart < end) {
+      size_t length = std::min(end - literalStart, MAX_LITERAL_LENGTH);
+      output.push_back((unsigned char)(length - 1));
+      output.insert(output.end(), data + literalStart, data + literalStart + length);
+      literalStart += length;
+    }
+  };
+
+  while (i < size) {
+    size_t runLength = 1;
+    while (i + runLength < size && runLength < MAX_RUN_LENGTH && data[i + runLength] == data[i]) {
+      runLength++;
+    }
+
+    if (runLength >= MIN_RUN_LENGTH) {
+      flushLiterals(i);
+      output.push_back((unsigned char)(runLength + 125));
+      output.push_back(data[i]);
+      i += runLength;
+      literalStart = i;
+    } else {
+      i += runLength;
+    }
+  }
+
+  flushLiterals(size);
+}
+
+bool RunLengthDecode(const unsigned char* data, size_t size, unsigned char* output, size_t outputSize) {
+  size_t in = 0;
+  size_t out = 0;
+
+  while (in < size) {
+    unsigned char control = data[in++];
+
+    if (control < 128) {
+      size_t length = (size_t)control + 1;
+      if (in + length > size || out + length > outputSize) return false;
+      std::memcpy(output + out, data + in, length);
+      in += length;
+      out += length;
+    } else {
+      size_t length = (size_t)control - 125;
+      if (in >= size || out + length > outputSize) return false;
+      std::memset(output + out, data[in++], length);
+      out += length;
+    }
+  }
+
+  return out == outputSize;
+}
+
+} // namespace Compression
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+namespace Compression {
+
+// PackBits style run-length encoding, voxel data is mostly made of long runs of the same byte
+void RunLengthEncode(const unsigned char* data, size_t size, std::vector<unsigned char>& output);
+// Returns false if the encoded data is corrupt or doesn't decode to exactly outputSize bytes
+bool RunLengthDecode(const unsigned char* data, size_t size, unsigned char* output, size_t outputSize);
+
+} // namespace Compression
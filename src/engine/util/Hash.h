@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// FNV-1a, for cache keys that only need to change when their inputs do
+namespace Hash {
+
+const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+const uint64_t FNV_PRIME = 1099511628211ULL;
+
+inline void AddBytes(uint64_t& hash, const void* data, size_t size) {
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= FNV_PRIME;
+  }
+}
+
+template <typename T>
+void AddValue(uint64_t& hash, const T& value) {
+  AddBytes(hash, &value, sizeof(T));
+}
+
+inline void AddString(uint64_t& hash, const std::string& value) {
+  AddBytes(hash, value.data(), value.size());
+  // Keeps ("ab", "c") apart from ("a", "bc")
+  AddBytes(hash, "", 1);
+}
+
+} // namespace Hash
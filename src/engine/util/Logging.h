@@ -3,6 +3,7 @@
 #include <iostream>
 #include <string>
 #include <mutex>
+#include <cstring>
 
 namespace {
 #define TERM_RESET "\033[0m"
@@ -0,0 +1,91 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "Logging.h"
+
+std::optional<MappedFile> MappedFile::Open(const std::string& path) {
+  MappedFile mappedFile;
+
+#ifdef _WIN32
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE) return std::nullopt;
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+    CloseHandle(file);
+    return std::nullopt;
+  }
+
+  HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  CloseHandle(file);
+  if (mapping == NULL) return std::nullopt;
+
+  void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (data == NULL) {
+    CloseHandle(mapping);
+    return std::nullopt;
+  }
+
+  mappedFile.m_data = static_cast<const unsigned char*>(data);
+  mappedFile.m_size = (size_t)size.QuadPart;
+  mappedFile.m_handle = mapping;
+#else
+  int file = open(path.c_str(), O_RDONLY);
+  if (file < 0) return std::nullopt;
+
+  struct stat fileStats;
+  if (fstat(file, &fileStats) != 0 || fileStats.st_size == 0) {
+    close(file);
+    return std::nullopt;
+  }
+
+  void* data = mmap(nullptr, fileStats.st_size, PROT_READ, MAP_SHARED, file, 0);
+  // The mapping stays valid after the descriptor is closed
+  close(file);
+  if (data == MAP_FAILED) {
+    LOG(ERROR) << "Failed to map file: " << path;
+    return std::nullopt;
+  }
+
+  mappedFile.m_data = static_cast<const unsigned char*>(data);
+  mappedFile.m_size = (size_t)fileStats.st_size;
+#endif
+
+  return mappedFile;
+}
+
+MappedFile::~MappedFile() {
+  Unmap();
+}
+
+const unsigned char* MappedFile::GetData() const {
+  return m_data;
+}
+
+size_t MappedFile::GetSize() const {
+  return m_size;
+}
+
+void MappedFile::Unmap() {
+  if (m_data == nullptr) return;
+
+#ifdef _WIN32
+  UnmapViewOfFile(m_data);
+  CloseHandle(m_handle);
+#else
+  munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+
+  m_data = nullptr;
+  m_size = 0;
+  m_handle = nullptr;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <optional>
+#include <cstddef>
+
+#include "util/ClassMacros.h"
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+  ONLY_MOVE(MappedFile) {
+    Unmap();
+    m_data = other.m_data;
+    m_size = other.m_size;
+    m_handle = other.m_handle;
+    other.m_data = nullptr;
+    other.m_size = 0;
+    other.m_handle = nullptr;
+    return *this;
+  }
+
+  static std::optional<MappedFile> Open(const std::string& path);
+  ~MappedFile();
+
+  const unsigned char* GetData() const;
+  size_t GetSize() const;
+
+private:
+  MappedFile() = default;
+
+  void Unmap();
+
+  const unsigned char* m_data = nullptr;
+  size_t m_size = 0;
+  // Platform specific mapping handle (only used on Windows)
+  void* m_handle = nullptr;
+};
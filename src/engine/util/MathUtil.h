@@ -1,6 +1,11 @@
 #pragma once
 
 #include <cmath>
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 #define XYZ(vector) vector.x, vector.y, vector.z
 
@@ -10,8 +15,13 @@ inline int Mod(int a, int b) {
   return (b + (a % b)) % b;
 }
 
+// Rounds towards negative infinity, unlike a / b
+inline int FloorDiv(int a, int b) {
+  return (a - Mod(a, b)) / b;
+}
+
 inline float fMod(float a, float b) {
-  return std::fmodf((b + (std::fmodf(a, b))), b);
+  return std::fmod((b + (std::fmod(a, b))), b);
 }
 
 inline double Map(double x, double inStart, double inEnd, double outStart, double outEnd) {
@@ -26,6 +36,17 @@ inline bool IsPowerOf2(int x) {
   return x > 0 && (x & (x - 1)) == 0;
 }
 
+// Index of the lowest set bit, x must not be 0
+inline int LowestSetBit(uint32_t x) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, x);
+  return index;
+#else
+  return __builtin_ctz(x);
+#endif
+}
+
 inline long long NearestPowerOf2(long long n) {
   long long a = std::log2(n);
 
@@ -1,26 +1,57 @@
 #include "Noise.h"
 
-OSN::Noise<2> Noise::s_noise2;
-OSN::Noise<3> Noise::s_noise3;
+#include <cmath>
+#include <cstdint>
 
-double Noise::Noise2D(double x, double y, double offsetX, double offsetY, double scale, int octaves, double persistence, double lacunarity) {
-  double total = 0.0;
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
 
-  double frequency = 1.0;
-  double amplitude = 1.0;
-  double totalAmplitude = 0.0;
+namespace {
 
-  for (int i = 0; i < octaves; i++) {
-    total += s_noise2.eval((x + offsetX) * frequency / scale, (y + offsetY) * frequency / scale) * amplitude;
-    totalAmplitude += amplitude;
-    amplitude *= persistence;
-    frequency *= lacunarity;
+bool CpuSupportsAVX2() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7) return false;
+
+  // The OS also has to save the AVX registers
+  __cpuid(info, 1);
+  bool hasAVX = (info[2] & (1 << 27)) && (info[2] & (1 << 28));
+  if (!hasAVX || (_xgetbv(0) & 0x6) != 0x6) return false;
+
+  __cpuidex(info, 7, 0);
+  return info[1] & (1 << 5);
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+  return __builtin_cpu_supports("avx2");
+#else
+  return false;
+#endif
+}
+
+} // namespace
+
+const NoiseKernels::Kernel* Noise::s_batchKernel = Noise::GetSupportedKernels().back();
+
+std::vector<const NoiseKernels::Kernel*> Noise::GetSupportedKernels() {
+  std::vector<const NoiseKernels::Kernel*> kernels = { nullptr };
+
+  if (const NoiseKernels::Kernel* sse2 = NoiseKernels::GetSSE2Kernel()) {
+    kernels.push_back(sse2);
+  }
+  if (const NoiseKernels::Kernel* avx2 = NoiseKernels::GetAVX2Kernel(); avx2 && CpuSupportsAVX2()) {
+    kernels.push_back(avx2);
   }
-  return total / totalAmplitude;
+
+  return kernels;
+}
+
+const NoiseKernels::Kernel* Noise::GetBatchKernel() {
+  return s_batchKernel;
 }
 
-double Noise::Noise3D(double x, double y, double z, double offsetX, double offsetY, double offsetZ, double scale) {
-  return s_noise3.eval((x + offsetX) / scale, (y + offsetY) / scale, (z + offsetZ) / scale);
+void Noise::SetBatchKernel(const NoiseKernels::Kernel* kernel) {
+  s_batchKernel = kernel;
 }
 
 double Noise::RandomNoise2D(double x, double y, double offsetX, double offsetY) {
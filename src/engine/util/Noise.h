@@ -1,17 +1,23 @@
 #pragma once
 
-#include <algorithm>
-#include <osn/OpenSimplexNoise.h>
+#include <vector>
 
+#include "noise/NoiseKernels.h"
+
+// Process-wide noise helpers. Seeded noise is sampled through a NoiseGenerator
 class Noise {
 public:
-  static double Noise2D(double x, double y, double offsetX, double offsetY, double scale, int octaves, double persistence, double lacunarity);
-  static double Noise3D(double x, double y, double z, double offsetX, double offsetY, double offsetZ, double scale);
-
+  // Hash of the coordinates in [0, 1], the same for every seed
   static double RandomNoise2D(double x, double y, double offsetX, double offsetY);
+
+  // The batched NoiseGenerator functions use the widest kernel the CPU supports, or the scalar OSN code (nullptr)
+  // if there are none
+  static std::vector<const NoiseKernels::Kernel*> GetSupportedKernels();
+  static const NoiseKernels::Kernel* GetBatchKernel();
+  // Not thread safe, only call while nothing is sampling noise
+  static void SetBatchKernel(const NoiseKernels::Kernel* kernel);
 private:
-  static OSN::Noise<2> s_noise2;
-  static OSN::Noise<3> s_noise3;
+  static const NoiseKernels::Kernel* s_batchKernel;
 
   static unsigned int HashCoord(int x, int y);
 };
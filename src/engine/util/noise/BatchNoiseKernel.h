@@ -0,0 +1,317 @@
+#pragma once
+
+// Lane-parallel versions of OSN::Noise<2>::eval and OSN::Noise<3>::eval.
+// Only include this from a kernel translation unit: it expects a lane type V with arithmetic, comparison
+// (returning all-ones masks) and bitwise operators, plus Select, Max, FastFloor and the gradient gathers.
+// The branches that pick the contributing lattice vertices are turned into masks, so every lane follows the
+// same instructions, and each vertex offset is combined into the distances the same way OSN does
+
+#include "NoiseKernels.h"
+
+// The contributions are called nine times per point, the compiler won't inline them on its own and passing the
+// lanes through memory costs more than the math
+#ifdef _MSC_VER
+#define NOISE_KERNEL_INLINE __forceinline
+#else
+#define NOISE_KERNEL_INLINE inline __attribute__((always_inline))
+#endif
+
+namespace NoiseKernels {
+namespace {
+
+const double STRETCH_2D = (1.0 / 1.7320508075688772 - 1.0) * 0.5; // (1 / sqrt(2 + 1) - 1) / 2
+const double SQUISH_2D = (1.7320508075688772 - 1.0) * 0.5;        // (sqrt(2 + 1) - 1) / 2
+const double NORM_2D = 1.0 / 47.0;
+
+const double STRETCH_3D = -1.0 / 6.0;
+const double SQUISH_3D = 1.0 / 3.0;
+const double NORM_3D = 1.0 / 103.0;
+
+// A lattice vertex given as an offset from the super-cell origin, one value per lane
+template <typename V>
+struct Offset3 {
+  V x, y, z;
+};
+
+// A point of the unit cube given by which axes are set (OSN encodes these as the bits 1, 2 and 4)
+template <typename V>
+struct AxisMask {
+  V x, y, z;
+};
+
+template <typename V>
+AxisMask<V> Select(V mask, const AxisMask<V>& a, const AxisMask<V>& b) {
+  return { Select(mask, a.x, b.x), Select(mask, a.y, b.y), Select(mask, a.z, b.z) };
+}
+
+template <typename V>
+Offset3<V> Select(V mask, const Offset3<V>& a, const Offset3<V>& b) {
+  return { Select(mask, a.x, b.x), Select(mask, a.y, b.y), Select(mask, a.z, b.z) };
+}
+
+template <typename V>
+NOISE_KERNEL_INLINE V Contribution2D(const Tables& tables, V xsb, V ysb, V dx0, V dy0, V ox, V oy) {
+  V squish = (ox + oy) * V::Splat(SQUISH_2D);
+  V dx = dx0 - ox - squish;
+  V dy = dy0 - oy - squish;
+
+  V attenuation = Max(V::Splat(2.0) - (dx * dx + dy * dy), V::Splat(0.0));
+  attenuation = attenuation * attenuation;
+
+  V gradientX, gradientY;
+  GatherGradients2D(tables, xsb + ox, ysb + oy, gradientX, gradientY);
+  return attenuation * attenuation * (gradientX * dx + gradientY * dy);
+}
+
+template <typename V>
+NOISE_KERNEL_INLINE V Contribution3D(const Tables& tables, const Offset3<V>& base, const Offset3<V>& d0, const Offset3<V>& offset, V active) {
+  V squish = (offset.x + offset.y + offset.z) * V::Splat(SQUISH_3D);
+  V dx = d0.x - offset.x - squish;
+  V dy = d0.y - offset.y - squish;
+  V dz = d0.z - offset.z - squish;
+
+  V attenuation = Max(V::Splat(2.0) - (dx * dx + dy * dy + dz * dz), V::Splat(0.0)) & active;
+  attenuation = attenuation * attenuation;
+
+  V gradientX, gradientY, gradientZ;
+  GatherGradients3D(tables, base.x + offset.x, base.y + offset.y, base.z + offset.z, gradientX, gradientY, gradientZ);
+  return attenuation * attenuation * (gradientX * dx + gradientY * dy + gradientZ * dz);
+}
+
+// (1,1,-1) permutation with the -1 on the first axis missing from the point
+template <typename V>
+Offset3<V> MissingAxisOffset(const AxisMask<V>& point) {
+  V one = V::Splat(1.0);
+  V minusOne = V::Splat(-1.0);
+  V onX = ~point.x;
+  V onY = point.x & ~point.y;
+  V onZ = point.x & point.y;
+  return { Select(onX, minusOne, one), Select(onY, minusOne, one), Select(onZ, minusOne, one) };
+}
+
+// (0,0,2) permutation with the 2 on the first axis set in the point
+template <typename V>
+Offset3<V> SetAxisOffset(const AxisMask<V>& point) {
+  V two = V::Splat(2.0);
+  V onX = point.x;
+  V onY = ~point.x & point.y;
+  V onZ = ~point.x & ~point.y;
+  return { onX & two, onY & two, onZ & two };
+}
+
+template <typename V>
+void Eval2D(const Tables& tables, const double* xIn, const double* yIn, int count, double amplitude, double* output) {
+  const V zero = V::Splat(0.0);
+  const V one = V::Splat(1.0);
+  const V two = V::Splat(2.0);
+  const V minusOne = V::Splat(-1.0);
+
+  for (int i = 0; i + V::COUNT <= count; i += V::COUNT) {
+    V x = V::Load(xIn + i);
+    V y = V::Load(yIn + i);
+
+    // Place the input coordinates on the grid and find the super-cell
+    V stretchOffset = (x + y) * V::Splat(STRETCH_2D);
+    V xs = x + stretchOffset;
+    V ys = y + stretchOffset;
+    V xsb = FastFloor(xs);
+    V ysb = FastFloor(ys);
+
+    V squishOffset = (xsb + ysb) * V::Splat(SQUISH_2D);
+    V dx0 = x - (xsb + squishOffset);
+    V dy0 = y - (ysb + squishOffset);
+    V xins = xs - xsb;
+    V yins = ys - ysb;
+    V inSum = xins + yins;
+
+    V lowerTriangle = inSum <= one;
+    V xGreater = xins > yins;
+
+    // Extra vertex, see OSN::Noise<2>::eval for the four cases
+    V lowerZins = one - inSum;
+    V lowerNear = (lowerZins > xins) | (lowerZins > yins);
+    V upperZins = two - inSum;
+    V upperNear = (upperZins < xins) | (upperZins < yins);
+
+    V extX = Select(lowerTriangle,
+      Select(lowerNear, Select(xGreater, one, minusOne), one),
+      Select(upperNear, Select(xGreater, two, zero), zero));
+    V extY = Select(lowerTriangle,
+      Select(lowerNear, Select(xGreater, minusOne, one), one),
+      Select(upperNear, Select(xGreater, zero, two), zero));
+
+    // (0,0) or (1,1)
+    V triangleOrigin = ~lowerTriangle & one;
+
+    V value = Contribution2D(tables, xsb, ysb, dx0, dy0, one, zero);
+    value = value + Contribution2D(tables, xsb, ysb, dx0, dy0, zero, one);
+    value = value + Contribution2D(tables, xsb, ysb, dx0, dy0, triangleOrigin, triangleOrigin);
+    value = value + Contribution2D(tables, xsb, ysb, dx0, dy0, extX, extY);
+
+    V result = V::Load(output + i) + value * V::Splat(NORM_2D) * V::Splat(amplitude);
+    result.Store(output + i);
+  }
+}
+
+template <typename V>
+void Eval3D(const Tables& tables, const double* xIn, const double* yIn, const double* zIn, int count, double* output) {
+  const V zero = V::Splat(0.0);
+  const V one = V::Splat(1.0);
+  const V two = V::Splat(2.0);
+  const V three = V::Splat(3.0);
+  const V minusOne = V::Splat(-1.0);
+  const V allLanes = zero == zero;
+
+  for (int i = 0; i + V::COUNT <= count; i += V::COUNT) {
+    V x = V::Load(xIn + i);
+    V y = V::Load(yIn + i);
+    V z = V::Load(zIn + i);
+
+    // Place the input coordinates on the simplectic lattice and find the super-cell
+    V stretchOffset = (x + y + z) * V::Splat(STRETCH_3D);
+    V xs = x + stretchOffset;
+    V ys = y + stretchOffset;
+    V zs = z + stretchOffset;
+    Offset3<V> base = { FastFloor(xs), FastFloor(ys), FastFloor(zs) };
+
+    V squishOffset = (base.x + base.y + base.z) * V::Splat(SQUISH_3D);
+    Offset3<V> d0 = { x - (base.x + squishOffset), y - (base.y + squishOffset), z - (base.z + squishOffset) };
+    V xins = xs - base.x;
+    V yins = ys - base.y;
+    V zins = zs - base.z;
+    V inSum = xins + yins + zins;
+
+    V inOctahedron = (inSum > one) & (inSum < two);
+    V inLower = inSum <= one;
+    V inUpper = ~(inOctahedron | inLower);
+
+    // Tetrahedron at (0,0,0): pick the closest two out of (1,0,0), (0,1,0) and (0,0,1)
+    Offset3<V> lowerExt0, lowerExt1;
+    {
+      V aScore = xins;
+      V bScore = yins;
+      V aToZ = (aScore < bScore) & (zins > aScore);
+      V bToZ = (aScore >= bScore) & (zins > bScore);
+      aScore = Select(aToZ, zins, aScore);
+      bScore = Select(bToZ, zins, bScore);
+      AxisMask<V> a = { ~aToZ, zero, aToZ };
+      AxisMask<V> b = { zero, ~bToZ, bToZ };
+
+      // (0,0,0) is one of the closest two vertices
+      V wins = one - inSum;
+      V originClosest = (wins > aScore) | (wins > bScore);
+      AxisMask<V> c = Select(bScore > aScore, b, a);
+      Offset3<V> originExt0 = { Select(c.x, one, minusOne), Select(c.y, one, Select(c.x, minusOne, zero)), Select(c.z, one, zero) };
+      Offset3<V> originExt1 = { Select(c.x, one, zero), Select(c.y, one, Select(c.x, zero, minusOne)), Select(c.z, one, minusOne) };
+
+      // Otherwise the extra vertices come from the closest two
+      AxisMask<V> both = { a.x | b.x, a.y | b.y, a.z | b.z };
+      Offset3<V> otherExt0 = { both.x & one, both.y & one, both.z & one };
+      Offset3<V> otherExt1 = { Select(both.x, one, minusOne), Select(both.y, one, minusOne), Select(both.z, one, minusOne) };
+
+      lowerExt0 = Select(originClosest, originExt0, otherExt0);
+      lowerExt1 = Select(originClosest, originExt1, otherExt1);
+    }
+
+    // Tetrahedron at (1,1,1): pick the closest two out of (1,1,0), (1,0,1) and (0,1,1)
+    Offset3<V> upperExt0, upperExt1;
+    {
+      V aScore = xins;
+      V bScore = yins;
+      V bToXY = (aScore <= bScore) & (zins < bScore);
+      V aToXY = (aScore > bScore) & (zins < aScore);
+      aScore = Select(aToXY, zins, aScore);
+      bScore = Select(bToXY, zins, bScore);
+      AxisMask<V> a = { aToXY, allLanes, ~aToXY };
+      AxisMask<V> b = { allLanes, bToXY, ~bToXY };
+
+      // (1,1,1) is one of the closest two vertices
+      V wins = three - inSum;
+      V cornerClosest = (wins < aScore) | (wins < bScore);
+      AxisMask<V> c = Select(bScore < aScore, b, a);
+      Offset3<V> cornerExt0 = { Select(c.x, two, zero), Select(c.y, Select(c.x, one, two), zero), c.z & one };
+      Offset3<V> cornerExt1 = { c.x & one, Select(c.y, Select(c.x, two, one), zero), c.z & two };
+
+      // Otherwise the extra vertices come from the axis the closest two share
+      AxisMask<V> shared = { a.x & b.x, a.y & b.y, a.z & b.z };
+      Offset3<V> otherExt0 = { shared.x & one, shared.y & one, shared.z & one };
+      Offset3<V> otherExt1 = { shared.x & two, shared.y & two, shared.z & two };
+
+      upperExt0 = Select(cornerClosest, cornerExt0, otherExt0);
+      upperExt1 = Select(cornerClosest, cornerExt1, otherExt1);
+    }
+
+    // Octahedron in between
+    Offset3<V> octahedronExt0, octahedronExt1;
+    {
+      // (1,1,0) or (0,0,1)
+      V p1 = xins + yins;
+      V aFar = p1 > one;
+      V aScore = Select(aFar, p1 - one, one - p1);
+      AxisMask<V> a = { aFar, aFar, ~aFar };
+
+      // (1,0,1) or (0,1,0)
+      V p2 = xins + zins;
+      V bFar = p2 > one;
+      V bScore = Select(bFar, p2 - one, one - p2);
+      AxisMask<V> b = { bFar, ~bFar, bFar };
+
+      // (0,1,1) or (1,0,0) replaces the furthest of the two if it's closer
+      V p3 = yins + zins;
+      V cFar = p3 > one;
+      V cScore = Select(cFar, p3 - one, one - p3);
+      AxisMask<V> c = { ~cFar, cFar, cFar };
+
+      V replaceB = (aScore > bScore) & (bScore < cScore);
+      V replaceA = (aScore <= bScore) & (aScore < cScore);
+      b = Select(replaceB, c, b);
+      bFar = Select(replaceB, cFar, bFar);
+      a = Select(replaceA, c, a);
+      aFar = Select(replaceA, cFar, aFar);
+
+      V bothFar = aFar & bFar;
+      V bothNear = ~aFar & ~bFar;
+
+      // Both on the (1,1,1) side
+      AxisMask<V> shared = { a.x & b.x, a.y & b.y, a.z & b.z };
+      Offset3<V> farExt0 = { one, one, one };
+      Offset3<V> farExt1 = SetAxisOffset(shared);
+
+      // Both on the (0,0,0) side
+      AxisMask<V> either = { a.x | b.x, a.y | b.y, a.z | b.z };
+      Offset3<V> nearExt0 = { zero, zero, zero };
+      Offset3<V> nearExt1 = MissingAxisOffset(either);
+
+      // One on each side
+      Offset3<V> mixedExt0 = MissingAxisOffset(Select(aFar, a, b));
+      Offset3<V> mixedExt1 = SetAxisOffset(Select(aFar, b, a));
+
+      octahedronExt0 = Select(bothFar, farExt0, Select(bothNear, nearExt0, mixedExt0));
+      octahedronExt1 = Select(bothFar, farExt1, Select(bothNear, nearExt1, mixedExt1));
+    }
+
+    Offset3<V> ext0 = Select(inOctahedron, octahedronExt0, Select(inLower, lowerExt0, upperExt0));
+    Offset3<V> ext1 = Select(inOctahedron, octahedronExt1, Select(inLower, lowerExt1, upperExt1));
+
+    // The tetrahedra use (0,0,0) or (1,1,1) and three of its neighbors, the octahedron uses the six vertices in between.
+    // Contributions are added in the same order as OSN
+    V upperOne = inUpper & one;
+    V notUpperOne = ~inUpper & one;
+    V tetrahedron = ~inOctahedron;
+
+    V value = Contribution3D(tables, base, d0, { upperOne, upperOne, upperOne }, tetrahedron);
+    value = value + Contribution3D(tables, base, d0, { notUpperOne, upperOne, upperOne }, allLanes);
+    value = value + Contribution3D(tables, base, d0, { upperOne, notUpperOne, upperOne }, allLanes);
+    value = value + Contribution3D(tables, base, d0, { upperOne, upperOne, notUpperOne }, allLanes);
+    value = value + Contribution3D(tables, base, d0, { one, one, zero }, inOctahedron);
+    value = value + Contribution3D(tables, base, d0, { one, zero, one }, inOctahedron);
+    value = value + Contribution3D(tables, base, d0, { zero, one, one }, inOctahedron);
+    value = value + Contribution3D(tables, base, d0, ext0, allLanes);
+    value = value + Contribution3D(tables, base, d0, ext1, allLanes);
+
+    (value * V::Splat(NORM_3D)).Store(output + i);
+  }
+}
+
+} // namespace
+} // namespace NoiseKernels
@@ -0,0 +1,52 @@
+#include "DensityGrid.h"
+
+#include "../MathUtil.h"
+
+void DensityGrid::Sample(const NoiseGenerator& noise, NoiseGenerator::Scratch& scratch, int x0, int y0, int z0, int width, int height, int depth, int spacing, const NoiseTransform& transform) {
+  m_spacing = spacing;
+  m_originX = MathUtil::FloorDiv(x0, spacing) * spacing;
+  m_originY = MathUtil::FloorDiv(y0, spacing) * spacing;
+  m_originZ = MathUtil::FloorDiv(z0, spacing) * spacing;
+
+  // Up to the far corner of the last block's cell, which Get reads even when the block is on a lattice point
+  int countX = MathUtil::FloorDiv(x0 + width - 1, spacing) - m_originX / spacing + 2;
+  m_countY = MathUtil::FloorDiv(y0 + height - 1, spacing) - m_originY / spacing + 2;
+  m_countZ = MathUtil::FloorDiv(z0 + depth - 1, spacing) - m_originZ / spacing + 2;
+  if (spacing == 1) {
+    // Every block is a lattice point
+    countX--;
+    m_countY--;
+    m_countZ--;
+  }
+
+  // Noise3DBlock samples whole coordinates, so sample the lattice in lattice units
+  m_samples.resize(countX * m_countY * m_countZ);
+  noise.Noise3DBlock(scratch, m_originX / spacing, m_originY / spacing, m_originZ / spacing, countX, m_countY, m_countZ,
+    transform.Scaled(spacing), m_samples.data());
+}
+
+double DensityGrid::Get(int x, int y, int z) const {
+  int dx = x - m_originX;
+  int dy = y - m_originY;
+  int dz = z - m_originZ;
+
+  if (m_spacing == 1) {
+    return GetSample(dx, dy, dz);
+  }
+
+  int ix = dx / m_spacing;
+  int iy = dy / m_spacing;
+  int iz = dz / m_spacing;
+  double tx = (double)(dx % m_spacing) / m_spacing;
+  double ty = (double)(dy % m_spacing) / m_spacing;
+  double tz = (double)(dz % m_spacing) / m_spacing;
+
+  double x00 = MathUtil::Lerp(GetSample(ix, iy, iz), GetSample(ix + 1, iy, iz), tx);
+  double x10 = MathUtil::Lerp(GetSample(ix, iy + 1, iz), GetSample(ix + 1, iy + 1, iz), tx);
+  double x01 = MathUtil::Lerp(GetSample(ix, iy, iz + 1), GetSample(ix + 1, iy, iz + 1), tx);
+  double x11 = MathUtil::Lerp(GetSample(ix, iy + 1, iz + 1), GetSample(ix + 1, iy + 1, iz + 1), tx);
+
+  double y0 = MathUtil::Lerp(x00, x10, ty);
+  double y1 = MathUtil::Lerp(x01, x11, ty);
+  return MathUtil::Lerp(y0, y1, tz);
+}
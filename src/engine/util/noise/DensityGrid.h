@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vector>
+
+#include "NoiseGenerator.h"
+
+// 3D noise sampled every `spacing` blocks and trilinearly interpolated in between, for smooth fields that don't need
+// a sample per block. The lattice is aligned to the world grid, so boxes next to each other interpolate the same values
+// on their shared faces. A spacing of 1 samples every block and returns the same values as NoiseGenerator::Noise3D
+class DensityGrid {
+public:
+  void Sample(const NoiseGenerator& noise, NoiseGenerator::Scratch& scratch, int x0, int y0, int z0, int width, int height, int depth, int spacing, const NoiseTransform& transform);
+
+  // World coordinates, inside the box given to Sample
+  double Get(int x, int y, int z) const;
+private:
+  int m_spacing = 1;
+  int m_originX = 0, m_originY = 0, m_originZ = 0;
+  int m_countY = 0, m_countZ = 0;
+
+  std::vector<double> m_samples;
+
+  double GetSample(int ix, int iy, int iz) const {
+    return m_samples[(ix * m_countZ + iz) * m_countY + iy];
+  }
+};
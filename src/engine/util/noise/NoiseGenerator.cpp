@@ -0,0 +1,141 @@
+#include "NoiseGenerator.h"
+
+#include <algorithm>
+
+#include "../Noise.h"
+
+namespace {
+
+// OSN keeps the permutation protected, the batched kernels need a copy of it
+struct PermutationAccess : OSN::NoiseBase {
+  static const int* Get(const OSN::NoiseBase& noise) {
+    return noise.*(&PermutationAccess::perm);
+  }
+};
+
+} // namespace
+
+NoiseTransform NoiseTransform::FromScale(double scale, double offsetX, double offsetY, double offsetZ) {
+  double frequency = 1.0 / scale;
+  return { frequency, offsetX * frequency, offsetY * frequency, offsetZ * frequency };
+}
+
+NoiseTransform NoiseTransform::Scaled(int spacing) const {
+  return { frequency * spacing, shiftX, shiftY, shiftZ };
+}
+
+FractalNoise2D FractalNoise2D::FromScale(double scale, double offsetX, double offsetY, int octaves, double persistence, double lacunarity) {
+  FractalNoise2D fractal;
+
+  double frequency = 1.0;
+  double amplitude = 1.0;
+  double totalAmplitude = 0.0;
+
+  for (int i = 0; i < octaves; i++) {
+    double octaveFrequency = frequency / scale;
+    fractal.octaves.push_back({ { octaveFrequency, offsetX * octaveFrequency, offsetY * octaveFrequency, 0.0 }, amplitude });
+    totalAmplitude += amplitude;
+    amplitude *= persistence;
+    frequency *= lacunarity;
+  }
+
+  fractal.inverseTotalAmplitude = 1.0 / totalAmplitude;
+  return fractal;
+}
+
+FractalNoise2D FractalNoise2D::Scaled(int spacing) const {
+  FractalNoise2D scaled = *this;
+  for (Octave& octave : scaled.octaves) {
+    octave.transform = octave.transform.Scaled(spacing);
+  }
+  return scaled;
+}
+
+NoiseGenerator::NoiseGenerator(int seed) : m_seed(seed), m_noise2(seed), m_noise3(seed) {
+  std::copy_n(PermutationAccess::Get(m_noise2), 256, m_kernelTables.perm2D);
+  std::copy_n(PermutationAccess::Get(m_noise3), 256, m_kernelTables.perm3D);
+  for (int i = 0; i < 256; i++) {
+    const int* gradient = NoiseKernels::GRADIENTS_3D + (m_kernelTables.perm3D[i] % 24) * 3;
+    m_kernelTables.packedGradient3D[i] = (gradient[0] & 0xFF) | (gradient[1] & 0xFF) << 8 | (gradient[2] & 0xFF) << 16;
+  }
+}
+
+int NoiseGenerator::GetSeed() const {
+  return m_seed;
+}
+
+double NoiseGenerator::Noise2D(double x, double y, const FractalNoise2D& fractal) const {
+  double total = 0.0;
+  for (const FractalNoise2D::Octave& octave : fractal.octaves) {
+    const NoiseTransform& transform = octave.transform;
+    total += m_noise2.eval(x * transform.frequency + transform.shiftX, y * transform.frequency + transform.shiftY) * octave.amplitude;
+  }
+  return total * fractal.inverseTotalAmplitude;
+}
+
+double NoiseGenerator::Noise3D(double x, double y, double z, const NoiseTransform& transform) const {
+  return m_noise3.eval(x * transform.frequency + transform.shiftX, y * transform.frequency + transform.shiftY, z * transform.frequency + transform.shiftZ);
+}
+
+void NoiseGenerator::Noise2DGrid(Scratch& scratch, double x0, double y0, int width, int height, const FractalNoise2D& fractal, double* output) const {
+  const NoiseKernels::Kernel* kernel = Noise::GetBatchKernel();
+  int count = width * height;
+  int batched = kernel ? count - count % kernel->lanes : 0;
+
+  scratch.x.resize(count);
+  scratch.y.resize(count);
+  std::fill(output, output + count, 0.0);
+
+  // Same operations as Noise2D, one octave at a time over the whole grid
+  for (const FractalNoise2D::Octave& octave : fractal.octaves) {
+    const NoiseTransform& transform = octave.transform;
+    for (int x = 0; x < width; x++) {
+      double noiseX = (x0 + x) * transform.frequency + transform.shiftX;
+      for (int y = 0; y < height; y++) {
+        scratch.x[x * height + y] = noiseX;
+        scratch.y[x * height + y] = (y0 + y) * transform.frequency + transform.shiftY;
+      }
+    }
+
+    if (batched > 0) {
+      kernel->eval2D(m_kernelTables, scratch.x.data(), scratch.y.data(), batched, octave.amplitude, output);
+    }
+    for (int i = batched; i < count; i++) {
+      output[i] += m_noise2.eval(scratch.x[i], scratch.y[i]) * octave.amplitude;
+    }
+  }
+
+  for (int i = 0; i < count; i++) {
+    output[i] *= fractal.inverseTotalAmplitude;
+  }
+}
+
+void NoiseGenerator::Noise3DBlock(Scratch& scratch, double x0, double y0, double z0, int width, int height, int depth, const NoiseTransform& transform, double* output) const {
+  const NoiseKernels::Kernel* kernel = Noise::GetBatchKernel();
+  int count = width * height * depth;
+  int batched = kernel && kernel->eval3D ? count - count % kernel->lanes : 0;
+
+  scratch.x.resize(count);
+  scratch.y.resize(count);
+  scratch.z.resize(count);
+
+  for (int x = 0; x < width; x++) {
+    double noiseX = (x0 + x) * transform.frequency + transform.shiftX;
+    for (int z = 0; z < depth; z++) {
+      double noiseZ = (z0 + z) * transform.frequency + transform.shiftZ;
+      for (int y = 0; y < height; y++) {
+        int i = (x * depth + z) * height + y;
+        scratch.x[i] = noiseX;
+        scratch.y[i] = (y0 + y) * transform.frequency + transform.shiftY;
+        scratch.z[i] = noiseZ;
+      }
+    }
+  }
+
+  if (batched > 0) {
+    kernel->eval3D(m_kernelTables, scratch.x.data(), scratch.y.data(), scratch.z.data(), batched, output);
+  }
+  for (int i = batched; i < count; i++) {
+    output[i] = m_noise3.eval(scratch.x[i], scratch.y[i], scratch.z[i]);
+  }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+#include <osn/OpenSimplexNoise.h>
+
+#include "NoiseKernels.h"
+
+// Maps world coordinates to noise coordinates. (x + offset) / scale is precomputed as x * frequency + shift, so
+// sampling only multiplies and adds
+struct NoiseTransform {
+  double frequency = 1.0;
+  double shiftX = 0.0, shiftY = 0.0, shiftZ = 0.0;
+
+  static NoiseTransform FromScale(double scale, double offsetX, double offsetY, double offsetZ = 0.0);
+  // The same mapping for coordinates given in units of `spacing` blocks
+  NoiseTransform Scaled(int spacing) const;
+};
+
+// Octaves of 2D noise added together, each octave with its own transform and amplitude
+struct FractalNoise2D {
+  struct Octave {
+    NoiseTransform transform;
+    double amplitude;
+  };
+
+  std::vector<Octave> octaves;
+  double inverseTotalAmplitude = 1.0;
+
+  static FractalNoise2D FromScale(double scale, double offsetX, double offsetY, int octaves, double persistence, double lacunarity);
+  // The same noise for coordinates given in units of `spacing` blocks
+  FractalNoise2D Scaled(int spacing) const;
+};
+
+// OpenSimplex noise for one seed. Sampling is const and only touches the caller's scratch memory, so several
+// generators, or several threads sharing one, can sample at the same time
+class NoiseGenerator {
+public:
+  // Coordinate buffers for the batched functions, keep one per thread and reuse it
+  struct Scratch {
+    std::vector<double> x, y, z;
+  };
+
+  explicit NoiseGenerator(int seed = 0);
+
+  int GetSeed() const;
+
+  double Noise2D(double x, double y, const FractalNoise2D& fractal) const;
+  double Noise3D(double x, double y, double z, const NoiseTransform& transform) const;
+
+  // Batched versions of the functions above over a grid of whole coordinates starting at (x0, y0[, z0]), with the
+  // same results. Noise2DGrid fills output[x * height + y], Noise3DBlock fills output[(x * depth + z) * height + y]
+  void Noise2DGrid(Scratch& scratch, double x0, double y0, int width, int height, const FractalNoise2D& fractal, double* output) const;
+  void Noise3DBlock(Scratch& scratch, double x0, double y0, double z0, int width, int height, int depth, const NoiseTransform& transform, double* output) const;
+private:
+  int m_seed;
+  OSN::Noise<2> m_noise2;
+  OSN::Noise<3> m_noise3;
+  NoiseKernels::Tables m_kernelTables;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+// Batched OpenSimplex kernels that match OSN::Noise<N>::eval. They only evaluate the first `count` points rounded down
+// to a multiple of their lane count, the caller evaluates the rest.
+// Kernels are compiled in their own translation units so they can use instruction sets the rest of the game doesn't
+namespace NoiseKernels {
+
+// Same gradients as OSN, which keeps them private
+alignas(64) const int GRADIENTS_2D[16] = {
+   5, 2,   2, 5,  -5, 2,  -2, 5,
+   5,-2,   2,-5,  -5,-2,  -2,-5
+};
+
+alignas(64) const int GRADIENTS_3D[72] = {
+  -11, 4, 4,  -4, 11, 4,  -4, 4, 11,   11, 4, 4,   4, 11, 4,   4, 4, 11,
+  -11,-4, 4,  -4,-11, 4,  -4,-4, 11,   11,-4, 4,   4,-11, 4,   4,-4, 11,
+  -11, 4,-4,  -4, 11,-4,  -4, 4,-11,   11, 4,-4,   4, 11,-4,   4, 4,-11,
+  -11,-4,-4,  -4,-11,-4,  -4,-4,-11,   11,-4,-4,   4,-11,-4,   4,-4,-11
+};
+
+// Copies of the permutations of the OSN generators the kernels replicate
+struct Tables {
+  int perm2D[256];
+  int perm3D[256];
+  // 3D gradient for each permutation value, packed as one signed byte per axis (x in the lowest byte) so the
+  // kernels can fetch it with a single lookup
+  int packedGradient3D[256];
+};
+
+// output[i] += eval(x[i], y[i]) * amplitude
+using Eval2DFunc = void (*)(const Tables& tables, const double* x, const double* y, int count, double amplitude, double* output);
+// output[i] = eval(x[i], y[i], z[i])
+using Eval3DFunc = void (*)(const Tables& tables, const double* x, const double* y, const double* z, int count, double* output);
+
+struct Kernel {
+  const char* name;
+  int lanes;
+  Eval2DFunc eval2D;
+  // nullptr when the scalar code is faster
+  Eval3DFunc eval3D;
+};
+
+// These return nullptr when the kernel was not compiled for the target architecture
+const Kernel* GetSSE2Kernel();
+const Kernel* GetAVX2Kernel();
+
+} // namespace NoiseKernels
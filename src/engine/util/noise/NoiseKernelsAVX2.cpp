@@ -0,0 +1,96 @@
+#include "NoiseKernels.h"
+
+// This file is compiled with AVX2 enabled (see CMakeLists.txt), it must not run any code before the CPU has been
+// checked for AVX2 support, so nothing here may need dynamic initialization
+#ifdef __AVX2__
+
+#include <immintrin.h>
+
+namespace {
+
+struct Lanes {
+  __m256d v;
+
+  static const int COUNT = 4;
+
+  static Lanes Load(const double* data) { return { _mm256_loadu_pd(data) }; }
+  static Lanes Splat(double value) { return { _mm256_set1_pd(value) }; }
+  void Store(double* data) const { _mm256_storeu_pd(data, v); }
+};
+
+inline Lanes operator+(Lanes a, Lanes b) { return { _mm256_add_pd(a.v, b.v) }; }
+inline Lanes operator-(Lanes a, Lanes b) { return { _mm256_sub_pd(a.v, b.v) }; }
+inline Lanes operator*(Lanes a, Lanes b) { return { _mm256_mul_pd(a.v, b.v) }; }
+inline Lanes operator&(Lanes a, Lanes b) { return { _mm256_and_pd(a.v, b.v) }; }
+inline Lanes operator|(Lanes a, Lanes b) { return { _mm256_or_pd(a.v, b.v) }; }
+inline Lanes operator~(Lanes a) { return { _mm256_xor_pd(a.v, _mm256_castsi256_pd(_mm256_set1_epi32(-1))) }; }
+inline Lanes operator<(Lanes a, Lanes b) { return { _mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ) }; }
+inline Lanes operator<=(Lanes a, Lanes b) { return { _mm256_cmp_pd(a.v, b.v, _CMP_LE_OQ) }; }
+inline Lanes operator>(Lanes a, Lanes b) { return { _mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ) }; }
+inline Lanes operator>=(Lanes a, Lanes b) { return { _mm256_cmp_pd(a.v, b.v, _CMP_GE_OQ) }; }
+inline Lanes operator==(Lanes a, Lanes b) { return { _mm256_cmp_pd(a.v, b.v, _CMP_EQ_OQ) }; }
+
+inline Lanes Select(Lanes mask, Lanes a, Lanes b) { return { _mm256_blendv_pd(b.v, a.v, mask.v) }; }
+
+inline Lanes Max(Lanes a, Lanes b) { return { _mm256_max_pd(a.v, b.v) }; }
+
+// Truncate, then step down for negative values (OSN's fastFloori, which also steps down negative integers)
+inline Lanes FastFloor(Lanes x) {
+  Lanes truncated = { _mm256_cvtepi32_pd(_mm256_cvttpd_epi32(x.v)) };
+  return truncated - ((x < Lanes::Splat(0.0)) & Lanes::Splat(1.0));
+}
+
+// The lattice coordinates are whole numbers, so the conversion is exact
+inline __m128i ToIndex(Lanes x) {
+  return _mm256_cvttpd_epi32(x.v);
+}
+
+inline __m128i PermLookup(const int* perm, __m128i index) {
+  return _mm_i32gather_epi32(perm, _mm_and_si128(index, _mm_set1_epi32(0xFF)), 4);
+}
+
+inline Lanes GatherGradient(const int* gradients, __m128i index) {
+  return { _mm256_cvtepi32_pd(_mm_i32gather_epi32(gradients, index, 4)) };
+}
+
+} // namespace
+
+#include "BatchNoiseKernel.h"
+
+namespace {
+
+inline void GatherGradients2D(const NoiseKernels::Tables& tables, Lanes x, Lanes y, Lanes& gradientX, Lanes& gradientY) {
+  __m128i hash = PermLookup(tables.perm2D, ToIndex(x));
+  hash = PermLookup(tables.perm2D, _mm_add_epi32(hash, ToIndex(y)));
+  __m128i index = _mm_and_si128(hash, _mm_set1_epi32(0x0E));
+
+  gradientX = GatherGradient(NoiseKernels::GRADIENTS_2D, index);
+  gradientY = GatherGradient(NoiseKernels::GRADIENTS_2D + 1, index);
+}
+
+inline void GatherGradients3D(const NoiseKernels::Tables& tables, Lanes x, Lanes y, Lanes z, Lanes& gradientX, Lanes& gradientY, Lanes& gradientZ) {
+  __m128i hash = PermLookup(tables.perm3D, ToIndex(x));
+  hash = PermLookup(tables.perm3D, _mm_add_epi32(hash, ToIndex(y)));
+  __m128i packed = PermLookup(tables.packedGradient3D, _mm_add_epi32(hash, ToIndex(z)));
+
+  // Shift each byte to the top and back down to sign extend it
+  gradientX = { _mm256_cvtepi32_pd(_mm_srai_epi32(_mm_slli_epi32(packed, 24), 24)) };
+  gradientY = { _mm256_cvtepi32_pd(_mm_srai_epi32(_mm_slli_epi32(packed, 16), 24)) };
+  gradientZ = { _mm256_cvtepi32_pd(_mm_srai_epi32(_mm_slli_epi32(packed, 8), 24)) };
+}
+
+const NoiseKernels::Kernel AVX2_KERNEL = { "AVX2", Lanes::COUNT, NoiseKernels::Eval2D<Lanes>, NoiseKernels::Eval3D<Lanes> };
+
+} // namespace
+
+const NoiseKernels::Kernel* NoiseKernels::GetAVX2Kernel() {
+  return &AVX2_KERNEL;
+}
+
+#else
+
+const NoiseKernels::Kernel* NoiseKernels::GetAVX2Kernel() {
+  return nullptr;
+}
+
+#endif
@@ -0,0 +1,91 @@
+#include "NoiseKernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LUISCRAFT_NOISE_SSE2
+#endif
+
+#ifdef LUISCRAFT_NOISE_SSE2
+
+#include <emmintrin.h>
+
+namespace {
+
+struct Lanes {
+  __m128d v;
+
+  static const int COUNT = 2;
+
+  static Lanes Load(const double* data) { return { _mm_loadu_pd(data) }; }
+  static Lanes Splat(double value) { return { _mm_set1_pd(value) }; }
+  void Store(double* data) const { _mm_storeu_pd(data, v); }
+};
+
+inline Lanes operator+(Lanes a, Lanes b) { return { _mm_add_pd(a.v, b.v) }; }
+inline Lanes operator-(Lanes a, Lanes b) { return { _mm_sub_pd(a.v, b.v) }; }
+inline Lanes operator*(Lanes a, Lanes b) { return { _mm_mul_pd(a.v, b.v) }; }
+inline Lanes operator&(Lanes a, Lanes b) { return { _mm_and_pd(a.v, b.v) }; }
+inline Lanes operator|(Lanes a, Lanes b) { return { _mm_or_pd(a.v, b.v) }; }
+inline Lanes operator~(Lanes a) { return { _mm_xor_pd(a.v, _mm_castsi128_pd(_mm_set1_epi32(-1))) }; }
+inline Lanes operator<(Lanes a, Lanes b) { return { _mm_cmplt_pd(a.v, b.v) }; }
+inline Lanes operator<=(Lanes a, Lanes b) { return { _mm_cmple_pd(a.v, b.v) }; }
+inline Lanes operator>(Lanes a, Lanes b) { return { _mm_cmpgt_pd(a.v, b.v) }; }
+inline Lanes operator>=(Lanes a, Lanes b) { return { _mm_cmpge_pd(a.v, b.v) }; }
+inline Lanes operator==(Lanes a, Lanes b) { return { _mm_cmpeq_pd(a.v, b.v) }; }
+
+inline Lanes Select(Lanes mask, Lanes a, Lanes b) {
+  return { _mm_or_pd(_mm_and_pd(mask.v, a.v), _mm_andnot_pd(mask.v, b.v)) };
+}
+
+inline Lanes Max(Lanes a, Lanes b) { return { _mm_max_pd(a.v, b.v) }; }
+
+// Truncate, then step down for negative values (OSN's fastFloori, which also steps down negative integers)
+inline Lanes FastFloor(Lanes x) {
+  Lanes truncated = { _mm_cvtepi32_pd(_mm_cvttpd_epi32(x.v)) };
+  return truncated - ((x < Lanes::Splat(0.0)) & Lanes::Splat(1.0));
+}
+
+// SSE2 has no gathers, so the permutation lookups are done one lane at a time
+inline void GatherGradients2D(const NoiseKernels::Tables& tables, Lanes x, Lanes y, Lanes& gradientX, Lanes& gradientY);
+
+} // namespace
+
+#include "BatchNoiseKernel.h"
+
+namespace {
+
+// The lattice coordinates are whole numbers, so the conversion is exact
+inline void ToIndices(Lanes x, int& first, int& second) {
+  __m128i index = _mm_cvttpd_epi32(x.v);
+  first = _mm_cvtsi128_si32(index);
+  second = _mm_cvtsi128_si32(_mm_srli_si128(index, 4));
+}
+
+inline void GatherGradients2D(const NoiseKernels::Tables& tables, Lanes x, Lanes y, Lanes& gradientX, Lanes& gradientY) {
+  int x0, x1, y0, y1;
+  ToIndices(x, x0, x1);
+  ToIndices(y, y0, y1);
+
+  int index0 = tables.perm2D[(tables.perm2D[x0 & 0xFF] + y0) & 0xFF] & 0x0E;
+  int index1 = tables.perm2D[(tables.perm2D[x1 & 0xFF] + y1) & 0xFF] & 0x0E;
+
+  gradientX = { _mm_cvtepi32_pd(_mm_set_epi32(0, 0, NoiseKernels::GRADIENTS_2D[index1], NoiseKernels::GRADIENTS_2D[index0])) };
+  gradientY = { _mm_cvtepi32_pd(_mm_set_epi32(0, 0, NoiseKernels::GRADIENTS_2D[index1 + 1], NoiseKernels::GRADIENTS_2D[index0 + 1])) };
+}
+
+// No 3D kernel: with two lanes and one lookup at a time, evaluating every simplex region for each point costs more
+// than OSN's branches, which predict well over terrain-sized blocks
+const NoiseKernels::Kernel SSE2_KERNEL = { "SSE2", Lanes::COUNT, NoiseKernels::Eval2D<Lanes>, nullptr };
+
+} // namespace
+
+const NoiseKernels::Kernel* NoiseKernels::GetSSE2Kernel() {
+  return &SSE2_KERNEL;
+}
+
+#else
+
+const NoiseKernels::Kernel* NoiseKernels::GetSSE2Kernel() {
+  return nullptr;
+}
+
+#endif
@@ -0,0 +1,89 @@
+#include "TaskPool.h"
+
+#include <algorithm>
+
+TaskPool& TaskPool::GetInstance() {
+  // The calling thread is the last worker of every loop
+  static TaskPool instance(std::max(1, (int)std::thread::hardware_concurrency()) - 1);
+  return instance;
+}
+
+TaskPool::TaskPool(int helperCount) {
+  for (int i = 0; i < helperCount; i++) {
+    m_helpers.push_back(std::thread([this]() {
+      HelperLoop();
+    }));
+  }
+}
+
+TaskPool::~TaskPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_workAvailable.notify_all();
+
+  for (std::thread& helper : m_helpers) {
+    helper.join();
+  }
+}
+
+void TaskPool::ParallelFor(int count, const std::function<void(int)>& task) {
+  if (m_helpers.empty() || count <= 1) {
+    for (int i = 0; i < count; i++) {
+      task(i);
+    }
+    return;
+  }
+
+  std::shared_ptr<Loop> loop = std::make_shared<Loop>(task, count);
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_loops.push_back(loop);
+  }
+  m_workAvailable.notify_all();
+
+  RunIterations(*loop);
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_loopFinished.wait(lock, [&]() { return loop->finished == count; });
+
+  // No helper claimed the last iterations, so the loop could still be waiting in the queue
+  auto it = std::find(m_loops.begin(), m_loops.end(), loop);
+  if (it != m_loops.end()) m_loops.erase(it);
+}
+
+int TaskPool::GetHelperCount() const {
+  return m_helpers.size();
+}
+
+void TaskPool::HelperLoop() {
+  while (true) {
+    std::shared_ptr<Loop> loop;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_workAvailable.wait(lock, [this]() { return m_stop || !m_loops.empty(); });
+      if (m_stop) return;
+      loop = m_loops.front();
+    }
+
+    RunIterations(*loop);
+
+    // Every iteration is claimed, the loop's own thread waits for the ones still running
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_loops.empty() && m_loops.front() == loop) m_loops.pop_front();
+  }
+}
+
+void TaskPool::RunIterations(Loop& loop) {
+  int i;
+  while ((i = loop.next.fetch_add(1)) < loop.count) {
+    loop.task(i);
+
+    if (loop.finished.fetch_add(1) + 1 == loop.count) {
+      // Locked so the wakeup can't slip in between the owner's check and its wait
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_loopFinished.notify_all();
+    }
+  }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <functional>
+
+#include "util/ClassMacros.h"
+
+// Helper threads that split a loop across cores, for work where latency matters more than throughput.
+// The calling thread runs iterations too, so a loop finishes even when every helper is busy with another one
+class TaskPool {
+public:
+  DELETE_COPY(TaskPool);
+
+  static TaskPool& GetInstance();
+
+  // Runs task(i) for every i in [0, count), possibly on several threads at once, and returns once all of them ran
+  void ParallelFor(int count, const std::function<void(int)>& task);
+
+  int GetHelperCount() const;
+
+private:
+  struct Loop {
+    const std::function<void(int)>& task;
+    int count;
+    std::atomic<int> next = 0;
+    std::atomic<int> finished = 0;
+
+    Loop(const std::function<void(int)>& task, int count) : task(task), count(count) {}
+  };
+
+  std::mutex m_mutex;
+  std::condition_variable m_workAvailable;
+  std::condition_variable m_loopFinished;
+  std::deque<std::shared_ptr<Loop>> m_loops;
+  bool m_stop = false;
+
+  std::vector<std::thread> m_helpers;
+
+  explicit TaskPool(int helperCount);
+  ~TaskPool();
+
+  void HelperLoop();
+  // Runs iterations until none are left to claim
+  void RunIterations(Loop& loop);
+};
@@ -31,7 +31,7 @@ public:
       return false;
     }
 
-    item = m_queue.front();
+    item = std::move(m_queue.front());
     m_queue.pop();
     return true;
   }
@@ -7,7 +7,11 @@
 
 template <typename Key, typename Value, typename Hasher = std::hash<Key>, typename Comparator = std::equal_to<Key>>
 class ThreadSafeUnorderedMap {
+  using Map = std::unordered_map<Key, Value, Hasher, Comparator>;
+
 public:
+  using NodeHandle = typename Map::node_type;
+
   void insert(const Key& key, const Value& value) {
     std::unique_lock<std::shared_mutex> lock(m_mutex);
     m_map[key] = value;
@@ -22,6 +26,16 @@ public:
     return std::nullopt;
   }
 
+  // Looks up the value and creates it if it's missing, all under a single lock
+  Value getOrInsert(const Key& key, const std::function<Value()>& createFunc) {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    auto it = m_map.find(key);
+    if (it == m_map.end()) {
+      it = m_map.emplace(key, createFunc()).first;
+    }
+    return it->second;
+  }
+
   bool contains(const Key& key) const {
     std::shared_lock<std::shared_mutex> lock(m_mutex);
     return m_map.find(key) != m_map.end();
@@ -32,6 +46,12 @@ public:
     m_map.erase(key);
   }
 
+  // Unlinks the entry without freeing it, so the node (and its value) can be destroyed on another thread
+  NodeHandle extract(const Key& key) {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    return m_map.extract(key);
+  }
+
   void clear() {
     std::unique_lock<std::shared_mutex> lock(m_mutex);
     m_map.clear();
@@ -59,5 +79,5 @@ public:
 
 private:
   mutable std::shared_mutex m_mutex;
-  std::unordered_map<Key, Value, Hasher, Comparator> m_map;
+  Map m_map;
 };
\ No newline at end of file
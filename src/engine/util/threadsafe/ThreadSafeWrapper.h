@@ -1,6 +1,7 @@
 #pragma once
 
 #include <shared_mutex>
+#include <mutex>
 
 template <typename T>
 class ThreadSafeWrapper {
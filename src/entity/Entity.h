@@ -4,7 +4,6 @@
 #include <glm/vec2.hpp>
 #include "../physics/BoundingBox.h"
 #include "util/threadsafe/ThreadSafeWrapper.h"
-#include "../engine/rendering/Shader.h"
 
 class Entity {
 public:
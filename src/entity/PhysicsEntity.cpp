@@ -2,7 +2,6 @@
 #include "../engine/io/Time.h"
 #include "../world/World.h"
 #include "../physics/AABB.h"
-#include "../debug/DebugShapes.h"
 #include "../block/Block.h"
 #include "../debug/DebugSettings.h"
 
@@ -1,10 +1,10 @@
 #include "Blocks.h"
-#include <glad/glad.h>
-#include "rendering/textures/TextureAtlasBuilder.h"
+#include "assets/TextureAtlasBuilder.h"
 #include <unordered_set>
 #include "../block/Block.h"
 #include "../block/BlockTextures.h"
 #include "util/Logging.h"
+#include "../debug/DebugSettings.h"
 
 void Blocks::InitializeBlocks() {
   for (auto& block : s_registry.GetAll()) {
@@ -14,6 +14,7 @@ void Blocks::InitializeBlocks() {
 
 void Blocks::GenerateBlockAtlas() {
   TextureAtlasBuilder atlasBuilder;
+  atlasBuilder.SetCacheFile(DebugSettings::instance.blockAtlasCacheFile);
 
   std::unordered_set<std::string> addedTextures { "" };
 
@@ -3,8 +3,9 @@
 #include "registry/Registry.h"
 #include "../block/Block.h"
 
-#include "rendering/textures/TextureAtlas.h"
+#include "assets/TextureAtlas.h"
 #include <optional>
+#include <memory>
 
 
 #define BLOCK(identifier, ...) inline static const Block& identifier = s_registry.Register(__VA_ARGS__);
@@ -26,9 +27,9 @@ public:
   BLOCK(BEDROCK, Block("bedrock", BlockTextures::All("block/bedrock")));
   BLOCK(OAK_LOG, Block("oak_log", BlockTextures::SideEnd("block/oak_log", "block/oak_log_top")));
   BLOCK(OAK_PLANKS, Block("oak_planks", BlockTextures::All("block/oak_planks")));
-  BLOCK(OAK_LEAVES, Block("oak_leaves", BlockTextures::All("block/oak_leaves")).NotSolid());
+  BLOCK(OAK_LEAVES, Block("oak_leaves", BlockTextures::All("block/oak_leaves")).NotSolid().Layer(RenderLayer::CUTOUT));
   BLOCK(GLOWSTONE, Block("glowstone", BlockTextures::All("block/glowstone")).LightLevel(15));
-  BLOCK(GLASS, Block("glass", BlockTextures::All("block/glass")).NotSolid().TransparentHidesNeighbors());
+  BLOCK(GLASS, Block("glass", BlockTextures::All("block/glass")).NotSolid().TransparentHidesNeighbors().Layer(RenderLayer::CUTOUT));
 
   static void InitializeBlocks();
   static void GenerateBlockAtlas();
@@ -6,12 +6,11 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <vector>
+#include <algorithm>
 
 #include "util/Logging.h"
 #include "util/OptionalMacros.h"
 #include "engine/rendering/Shader.h"
-#include "engine/rendering/textures/TextureAtlasBuilder.h"
-#include "engine/rendering/textures/TextureAtlas.h"
 #include "engine/io/Window.h"
 #include "engine/io/Input.h"
 #include "engine/io/Time.h"
@@ -22,6 +21,7 @@
 #include "engine/rendering/ShaderLibrary.h"
 #include "engine/rendering/buffers/ResourceGraveyard.h"
 #include "world/World.h"
+#include "render/WorldRenderer.h"
 #include "init/Blocks.h"
 #include "ui/GameUI.h"
 
@@ -44,6 +44,7 @@ int main() {
   player.SetPosition({ 0.0, 90.0, 16.0 });
 
   World world(player);
+  WorldRenderer worldRenderer(world);
   world.Start();
   player.Setup(&world);
 
@@ -51,6 +52,7 @@ int main() {
   Blocks::GenerateBlockAtlas();
 
   ShaderLibrary& shaders = ShaderLibrary::GetInstance();
+  shaders.SetBinaryCacheDirectory(DebugSettings::instance.useShaderCache ? DebugSettings::instance.shaderCacheDirectory : "");
   shaders.LoadShaders();
 
   window.Setup();
@@ -84,12 +86,14 @@ int main() {
     fov = fov + (DebugSettings::instance.defaultFOV * player.GetFOVChange() - fov) * (Time::deltaTime / fovChangeTime);
     float currentFOV = player.GetFOVOverride().value_or(fov);
 
-    projection = glm::perspective(glm::radians(currentFOV), window.GetAspectRatio(), 0.01f, 1000.0f);
+    // Far enough for the far terrain tiles, even looking along a diagonal
+    int viewDistance = std::max(DebugSettings::instance.renderDistance, DebugSettings::instance.lodDistance) + 1;
+    float farPlane = std::max(1000.0f, viewDistance * Chunk::CHUNK_WIDTH * 1.5f);
+    projection = glm::perspective(glm::radians(currentFOV), window.GetAspectRatio(), 0.01f, farPlane);
 
-    shaders.LoadMatrix4f("projection", projection);
-    shaders.LoadMatrix4f("view", view);
+    shaders.SetCamera(projection, view);
 
-    world.Draw();
+    worldRenderer.Draw();
 
     if (player.GetLookingAtBlock().has_value()) {
       DebugShapes::DrawBlockBox(*player.GetLookingAtBlock(), { 0.0f, 0.0f, 0.0f });
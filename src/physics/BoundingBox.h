@@ -1,11 +1,7 @@
 #pragma once
 
-#include "rendering/meshes/LineMesh.h"
-
 struct BoundingBox {
 
   double width, height;
 
-  LineMesh GetDebugMesh() const;
-
 };
\ No newline at end of file
@@ -0,0 +1,35 @@
+#include "GLRenderBackend.h"
+
+void GLMeshBuffers::SetData(const MeshData& data, size_t vertexCapacity, size_t indexCapacity) {
+  if (vertexCapacity <= data.vertices.size() && indexCapacity <= data.indices.size()) {
+    m_mesh.SetData(data.vertices.data(), data.vertices.size(), data.indices.data(), data.indices.size());
+  } else {
+    m_mesh.SetData(data.vertices.data(), data.vertices.size(), data.indices.data(), data.indices.size(),
+      vertexCapacity, indexCapacity);
+  }
+}
+
+bool GLMeshBuffers::PatchData(const float* vertices, size_t vertexOffset, size_t vertexCount,
+  const unsigned int* indices, size_t indexOffset, size_t indexCount, size_t totalIndexCount) {
+  return m_mesh.PatchData(vertices, vertexOffset, vertexCount, indices, indexOffset, indexCount, totalIndexCount);
+}
+
+void GLMeshBuffers::Draw() const {
+  m_mesh.Draw();
+}
+
+void GLLightVolume::SetData(int size, const unsigned char* cells) {
+  m_texture.SetData(size, size, size, cells);
+}
+
+void GLLightVolume::Use(unsigned int slot) const {
+  m_texture.Use(slot);
+}
+
+std::unique_ptr<MeshBuffers> GLRenderBackend::CreateMeshBuffers() {
+  return std::make_unique<GLMeshBuffers>();
+}
+
+std::unique_ptr<LightVolumeBuffer> GLRenderBackend::CreateLightVolume() {
+  return std::make_unique<GLLightVolume>();
+}
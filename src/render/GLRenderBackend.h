@@ -0,0 +1,34 @@
+#pragma once
+
+#include "../world/RenderBackend.h"
+#include "rendering/meshes/Mesh.h"
+#include "rendering/textures/Texture3D.h"
+
+// Mesh and texture handles are only queued for deletion by their destructors, so the world can free these anywhere
+class GLMeshBuffers : public MeshBuffers {
+public:
+  void SetData(const MeshData& data, size_t vertexCapacity = 0, size_t indexCapacity = 0) override;
+  bool PatchData(const float* vertices, size_t vertexOffset, size_t vertexCount,
+    const unsigned int* indices, size_t indexOffset, size_t indexCount, size_t totalIndexCount) override;
+
+  void Draw() const;
+
+private:
+  Mesh m_mesh;
+};
+
+class GLLightVolume : public LightVolumeBuffer {
+public:
+  void SetData(int size, const unsigned char* cells) override;
+
+  void Use(unsigned int slot) const;
+
+private:
+  Texture3D m_texture;
+};
+
+class GLRenderBackend : public RenderBackend {
+public:
+  std::unique_ptr<MeshBuffers> CreateMeshBuffers() override;
+  std::unique_ptr<LightVolumeBuffer> CreateLightVolume() override;
+};
@@ -0,0 +1,124 @@
+#include <glad/glad.h>
+
+#include "WorldRenderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "rendering/ShaderLibrary.h"
+#include "rendering/buffers/ResourceGraveyard.h"
+#include "../debug/DebugSettings.h"
+#include "../init/Blocks.h"
+
+namespace {
+
+// Loaded for every subchunk and tile drawn
+const Shader::UniformId MODEL_UNIFORM = Shader::GetUniformId("model");
+const Shader::UniformId USE_LIGHT_VOLUME_UNIFORM = Shader::GetUniformId("useLightVolume");
+
+// Subchunks ordered by how far their middle is from the eye's height, nearest first unless asked otherwise.
+// The same for every chunk
+std::vector<int> GetSubchunkOrder(float eyeY, bool farthestFirst) {
+  std::vector<int> order(Chunk::SUBCHUNK_LAYERS);
+  for (int i = 0; i < Chunk::SUBCHUNK_LAYERS; i++) order[i] = i;
+  auto distance = [&](int i) { return std::abs((i + 0.5f) * Chunk::SUBCHUNK_HEIGHT - eyeY); };
+  std::sort(order.begin(), order.end(), [&](int a, int b) {
+    return farthestFirst ? distance(a) > distance(b) : distance(a) < distance(b);
+  });
+  return order;
+}
+
+} // namespace
+
+WorldRenderer::WorldRenderer(World& world) : m_world(world) {
+  m_world.SetRenderBackend(&m_backend);
+}
+
+WorldRenderer::~WorldRenderer() {
+  m_world.SetRenderBackend(nullptr);
+}
+
+void WorldRenderer::Draw() {
+  // Buffers the world and its workers freed since the last frame
+  ResourceGraveyard::GetInstance().Flush();
+  UpdateAtlasTexture();
+
+  Shader& shader = ShaderLibrary::GetInstance().Get("main");
+  Shader& cutoutShader = ShaderLibrary::GetInstance().Get("main_cutout");
+  for (Shader* program : { &cutoutShader, &shader }) {
+    program->Use();
+    program->LoadBool("nightVision", DebugSettings::instance.nightVision);
+    program->LoadBool("nightTime", DebugSettings::instance.nightTime);
+    program->LoadBool("smoothLighting", DebugSettings::instance.smoothLighting);
+    program->LoadInt("lightVolume", 1);
+  }
+  m_atlasTexture->Use();
+
+  const Entity& camera = m_world.GetTrackingEntity();
+  glm::vec3 eye = camera.GetPosition() + glm::dvec3(0.0, camera.GetEyeLevel(), 0.0);
+  const std::vector<std::shared_ptr<Chunk>>& chunks = m_world.GetActiveChunks();
+  std::vector<int> nearestFirst = GetSubchunkOrder(eye.y, /*farthestFirst=*/false);
+  std::vector<int> farthestFirst = GetSubchunkOrder(eye.y, /*farthestFirst=*/true);
+
+  // Opaque faces go first and front to back. The main shader never discards, so early depth testing skips the
+  // hidden ones
+  for (const std::shared_ptr<Chunk>& chunk : chunks) {
+    DrawChunk(*chunk, shader, RenderLayer::SOLID, nearestFirst);
+  }
+
+  // Far terrain keeps its lights in the vertices
+  shader.LoadBool(USE_LIGHT_VOLUME_UNIFORM, false);
+  for (const std::shared_ptr<LodTile>& tile : m_world.GetActiveLodTiles()) {
+    const GLMeshBuffers* mesh = static_cast<const GLMeshBuffers*>(tile->GetMeshBuffers());
+    if (mesh == nullptr) continue;
+
+    glm::ivec2 origin = tile->GetFirstChunk() * Chunk::CHUNK_WIDTH;
+    shader.LoadMatrix4f(MODEL_UNIFORM, glm::translate(glm::mat4(1.0f), { origin.x, 0, origin.y }));
+    mesh->Draw();
+  }
+
+  cutoutShader.Use();
+  for (const std::shared_ptr<Chunk>& chunk : chunks) {
+    DrawChunk(*chunk, cutoutShader, RenderLayer::CUTOUT, nearestFirst);
+  }
+
+  // Translucent faces blend over everything else, back to front and without hiding each other
+  shader.Use();
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  glDepthMask(GL_FALSE);
+  for (auto it = chunks.rbegin(); it != chunks.rend(); it++) {
+    DrawChunk(**it, shader, RenderLayer::TRANSLUCENT, farthestFirst);
+  }
+  glDepthMask(GL_TRUE);
+  glDisable(GL_BLEND);
+}
+
+void WorldRenderer::UpdateAtlasTexture() {
+  // A rebuilt atlas is made before the old one is freed, so it never has the old one's address
+  const TextureAtlas& atlas = Blocks::GetAtlas();
+  if (&atlas == m_atlasSource) return;
+
+  m_atlasTexture.emplace(atlas.GetSize(), atlas.GetSize(), atlas.GetPixels().data(), /*mipmapLevels=*/3);
+  m_atlasSource = &atlas;
+}
+
+void WorldRenderer::DrawChunk(const Chunk& chunk, Shader& shader, RenderLayer layer, const std::vector<int>& order) const {
+  // TODO: Use some sort of frustum culling to prevent non-visible chunks from being drawn
+  if (!chunk.IsDrawable()) return;
+
+  glm::ivec2 chunkCoord = chunk.GetChunkCoord();
+  glm::vec3 origin = { chunkCoord.x * Chunk::CHUNK_WIDTH, 0, chunkCoord.y * Chunk::CHUNK_WIDTH };
+  for (int i : order) {
+    const GLMeshBuffers* mesh = static_cast<const GLMeshBuffers*>(chunk.GetMeshBuffers(i, layer));
+    if (mesh == nullptr) continue;
+
+    shader.LoadMatrix4f(MODEL_UNIFORM, glm::translate(glm::mat4(1.0f), origin + glm::vec3(0, i * Chunk::SUBCHUNK_HEIGHT, 0)));
+    // Subchunks meshed before light volumes were enabled still have their lights baked in
+    const GLLightVolume* lightVolume = static_cast<const GLLightVolume*>(chunk.GetLightVolume(i));
+    shader.LoadBool(USE_LIGHT_VOLUME_UNIFORM, lightVolume != nullptr);
+    if (lightVolume != nullptr) lightVolume->Use(1);
+    mesh->Draw();
+  }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "util/ClassMacros.h"
+#include "rendering/Shader.h"
+#include "rendering/textures/Texture.h"
+#include "GLRenderBackend.h"
+#include "../world/World.h"
+
+// Draws the world with OpenGL. It's the world's render backend while it exists, so every buffer the chunks and
+// tiles hold was made by it
+class WorldRenderer {
+public:
+  DELETE_COPY(WorldRenderer);
+
+  explicit WorldRenderer(World& world);
+  ~WorldRenderer();
+
+  void Draw();
+
+private:
+  World& m_world;
+  GLRenderBackend m_backend;
+
+  // Made from the block atlas, and again whenever the atlas is rebuilt
+  std::optional<Texture> m_atlasTexture;
+  const TextureAtlas* m_atlasSource = nullptr;
+
+  void UpdateAtlasTexture();
+  // Draws the faces of one render layer, going through the subchunks in the given order
+  void DrawChunk(const Chunk& chunk, Shader& shader, RenderLayer layer, const std::vector<int>& order) const;
+};
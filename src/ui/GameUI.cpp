@@ -18,7 +18,7 @@ GameUI::GameUI(PlayerEntity& player) : m_hotbarLayer(player), m_crosshairTexture
 void GameUI::Update(const Window& window) {
   glm::ivec2 windowSize = window.GetSize();
   glm::mat4 projection2D = glm::ortho(0.0f, (float)windowSize.x, (float)windowSize.y, 0.0f);
-  ShaderLibrary::GetInstance().LoadMatrix4f("projection2D", projection2D);
+  ShaderLibrary::GetInstance().SetProjection2D(projection2D);
 
   m_hotbarLayer.Resize(windowSize);
   m_crosshairLayer.Resize(windowSize);
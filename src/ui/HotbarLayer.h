@@ -2,6 +2,7 @@
 
 #include "rendering/ui/UILayer.h"
 #include "rendering/ui/drawables/UIColoredQuad.h"
+#include "rendering/textures/Texture.h"
 #include "../init/Blocks.h"
 #include "../entity/PlayerEntity.h"
 
@@ -0,0 +1,167 @@
+#include "CornerLightCache.h"
+
+#include <array>
+
+#include "VoxelData.h"
+#include "../world/Chunk.h"
+#include "../block/Block.h"
+#include "../debug/DebugSettings.h"
+
+namespace {
+
+// Corners dim by a quarter for each solid cell around them
+const float OCCLUSION[4] = { 1.0f, 0.75f, 0.5f, 0.25f };
+// Turns the sum of the open cells' lights into their average from 0 to 1, with the occlusion applied
+const float CORNER_SCALES[5] = {
+  0.0f, OCCLUSION[3] / 15.0f, OCCLUSION[2] / 30.0f, OCCLUSION[1] / 45.0f, OCCLUSION[0] / 60.0f
+};
+
+int NormalAxis(glm::ivec3 offset) {
+  return offset.x != 0 ? 0 : (offset.y != 0 ? 1 : 2);
+}
+
+} // namespace
+
+void CornerLightCache::Build(Chunk& chunk, glm::ivec3 min, glm::ivec3 size) {
+  m_min = min;
+  m_size = size;
+  m_smooth = DebugSettings::instance.smoothLighting;
+
+  glm::ivec3 padded = size + 2;
+  int cellCount = padded.x * padded.y * padded.z;
+  m_skyLights.resize(cellCount);
+  m_blockLights.resize(cellCount);
+  m_solid.resize(cellCount);
+
+  // Each blockstate's block is only looked up once
+  std::array<signed char, 256> solidBlockstates;
+  solidBlockstates.fill(-1);
+
+  for (int px = 0; px < padded.x; px++) {
+    for (int pz = 0; pz < padded.z; pz++) {
+      int x = min.x - 1 + px;
+      int z = min.z - 1 + pz;
+
+      // Columns outside the chunk are read from the neighbor directly, instead of looking it up for every cell
+      Chunk* source = &chunk;
+      glm::ivec3 local = { x, 0, z };
+      std::shared_ptr<Chunk> neighbor;
+      if (x < 0 || x >= Chunk::CHUNK_WIDTH || z < 0 || z >= Chunk::CHUNK_WIDTH) {
+        neighbor = chunk.GetNeighbor(x, z);
+        source = neighbor.get();
+        local = chunk.ToNeighborCoords(x, 0, z);
+      }
+
+      for (int py = 0; py < padded.y; py++) {
+        int y = min.y - 1 + py;
+        int index = CellIndex({ px, py, pz });
+
+        if (y >= Chunk::CHUNK_HEIGHT) {
+          // Open sky above the world
+          m_skyLights[index] = 15;
+          m_blockLights[index] = 0;
+          m_solid[index] = false;
+        } else if (y < 0 || source == nullptr) {
+          m_skyLights[index] = 0;
+          m_blockLights[index] = 0;
+          m_solid[index] = false;
+        } else {
+          int chunkIndex = source->PosToIndex(local.x, y, local.z);
+          Blockstate blockstate = source->m_blockstates[chunkIndex];
+          signed char& solid = solidBlockstates[blockstate];
+          if (solid < 0) solid = Block::FromBlockstate(blockstate).IsSolid();
+
+          SkyBlockLight light = source->m_lights[chunkIndex];
+          m_skyLights[index] = light.GetLight(LightType::SKY);
+          m_blockLights[index] = light.GetLight(LightType::BLOCK);
+          m_solid[index] = solid;
+        }
+      }
+    }
+  }
+
+  if (!m_smooth) return;
+
+  // Distance between neighboring cells along each axis
+  const int strides[3] = { padded.y * padded.z, padded.z, 1 };
+  const unsigned char* skyLights = m_skyLights.data();
+  const unsigned char* blockLights = m_blockLights.data();
+  const unsigned char* solid = m_solid.data();
+
+  for (int axis = 0; axis < 3; axis++) {
+    // The other two axes, the corners between the cells of a layer run along them
+    int u = (axis + 1) % 3;
+    int v = (axis + 2) % 3;
+    int layers = padded[axis];
+    int cornersU = size[u] + 1;
+    int cornersV = size[v] + 1;
+    int strideLayer = strides[axis];
+    int strideU = strides[u];
+    int strideV = strides[v];
+
+    m_corners[axis].resize(layers * cornersU * cornersV);
+    Corner* corner = m_corners[axis].data();
+
+    for (int layer = 0; layer < layers; layer++) {
+      for (int cu = 0; cu < cornersU; cu++) {
+        for (int cv = 0; cv < cornersV; cv++, corner++) {
+          // The 4 cells around the corner: 0 and 3 are diagonal to each other, as are 1 and 2
+          int first = layer * strideLayer + cu * strideU + cv * strideV;
+          const int cells[4] = { first, first + strideU, first + strideV, first + strideU + strideV };
+
+          int openCount = 0;
+          int skySum = 0;
+          int blockSum = 0;
+          for (int cell : cells) {
+            int open = 1 - solid[cell];
+            openCount += open;
+            skySum += open * skyLights[cell];
+            blockSum += open * blockLights[cell];
+          }
+
+          // The average of the open cells, dimmed by the solid ones
+          corner->skyLight = skySum * CORNER_SCALES[openCount];
+          corner->blockLight = blockSum * CORNER_SCALES[openCount];
+          corner->isolated = openCount == 2 && solid[cells[0]] == solid[cells[3]];
+        }
+      }
+    }
+  }
+}
+
+void CornerLightCache::GetCornerLight(glm::ivec3 block, Direction face, glm::ivec3 corner, float& skyLight, float& blockLight) const {
+  glm::ivec3 offset = VoxelData::GetFaceOffset(face);
+  int front = CellIndex(block + offset - m_min + 1);
+
+  float scale = 1.0f / 15.0f;
+  if (m_smooth) {
+    int axis = NormalAxis(offset);
+    int u = (axis + 1) % 3;
+    int v = (axis + 2) % 3;
+
+    glm::ivec3 relative = corner - m_min;
+    int layer = block[axis] + offset[axis] - m_min[axis] + 1;
+    const Corner& cached = m_corners[axis][CornerIndex(axis, layer, { relative[u], relative[v], 0 })];
+    if (!cached.isolated) {
+      skyLight = cached.skyLight;
+      blockLight = cached.blockLight;
+      return;
+    }
+
+    // Both other cells are solid and they hide the diagonal one
+    scale *= OCCLUSION[3];
+  }
+
+  skyLight = m_skyLights[front] * scale;
+  blockLight = m_blockLights[front] * scale;
+}
+
+int CornerLightCache::CellIndex(glm::ivec3 padded) const {
+  return (padded.x * (m_size.y + 2) + padded.y) * (m_size.z + 2) + padded.z;
+}
+
+int CornerLightCache::CornerIndex(int axis, int layer, glm::ivec3 corner) const {
+  int u = (axis + 1) % 3;
+  int v = (axis + 2) % 3;
+  return (layer * (m_size[u] + 1) + corner.x) * (m_size[v] + 1) + corner.y;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+#include <glm/vec3.hpp>
+
+#include "Direction.h"
+
+class Chunk;
+
+// Smooth light and ambient occlusion at the face corners of a box of blocks. A corner only depends on the 4 cells
+// around it in front of the face, so it is worked out once for all the faces sharing it
+class CornerLightCache {
+public:
+  // Reads the blocks in [min, min + size) of the chunk, in local coordinates, and the cells around them
+  void Build(Chunk& chunk, glm::ivec3 min, glm::ivec3 size);
+
+  // Sky and block light, from 0 to 1, at a corner (in local coordinates) of the face of a block in the box
+  void GetCornerLight(glm::ivec3 block, Direction face, glm::ivec3 corner, float& skyLight, float& blockLight) const;
+
+private:
+  struct Corner {
+    float skyLight;
+    float blockLight;
+    // Only the cells diagonal to each other are open, so each face only sees its own cell
+    bool isolated;
+  };
+
+  glm::ivec3 m_min;
+  glm::ivec3 m_size;
+  bool m_smooth = false;
+
+  // The box and one cell around it, z first, then y, then x
+  std::vector<unsigned char> m_skyLights;
+  std::vector<unsigned char> m_blockLights;
+  std::vector<unsigned char> m_solid;
+
+  // Per axis of the face normal: each layer of cells, then the corners between them in the other two axes
+  std::vector<Corner> m_corners[3];
+
+  int CellIndex(glm::ivec3 padded) const;
+  int CornerIndex(int axis, int layer, glm::ivec3 corner) const;
+};
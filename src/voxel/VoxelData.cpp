@@ -4,115 +4,50 @@
 #include "../init/Blocks.h"
 #include "util/Logging.h"
 #include "util/MathUtil.h"
-#include "../debug/DebugSettings.h"
-#include <array>
-#include <cmath>
+#include <algorithm>
 
 namespace {
 
-// TODO: Fix this function, it doesn't really work. Honestly, look up a better way to do ambient lighting.
-float NormalizeAmbientLighting(float l1, float l2, float l3, float l4) {
-  std::array<float*, 4> lightValues = { &l1, &l2, &l3, &l4 };
-  float nonNegativeAverage = 0.0f;
-  int nonNegativeCount = 0;
-
-  for (float* value : lightValues) {
-    if (*value > 0.0f) {
-      nonNegativeCount++;
-      nonNegativeAverage += *value;
-    }
-  }
-
-  if (nonNegativeCount == 0) {
-    nonNegativeAverage = 0.0f;
-  } else {
-    nonNegativeAverage /= (float)nonNegativeCount;
-  }
-
-  for (float* value : lightValues) {
-    if (*value < 0.0f) {
-      *value = std::max(floor(nonNegativeAverage) * 0.2f - 0.1f, -1.0f / 15.0f);
-    }
-  }
-
-  return (l1 + l2 + l3 + l4) / 4.0f;
-}
+// Corners of each face in the order they are emitted, as offsets from the block's lowest corner
+const glm::ivec3 FACE_CORNERS[6][4] = {
+  { {0, 1, 1}, {0, 0, 1}, {1, 0, 1}, {1, 1, 1} }, // SOUTH
+  { {1, 1, 0}, {1, 0, 0}, {0, 0, 0}, {0, 1, 0} }, // NORTH
+  { {1, 1, 1}, {1, 0, 1}, {1, 0, 0}, {1, 1, 0} }, // EAST
+  { {0, 1, 0}, {0, 0, 0}, {0, 0, 1}, {0, 1, 1} }, // WEST
+  { {0, 1, 0}, {0, 1, 1}, {1, 1, 1}, {1, 1, 0} }, // UP
+  { {1, 0, 0}, {1, 0, 1}, {0, 0, 1}, {0, 0, 0} }  // DOWN
+};
 
 }  // namespace
 
 // This function gets called millions of times. Once per each rendered face when generating chunks
 // After adding proper data blockstates, this wont be needed
-std::vector<float> VoxelData::GetFaceVertices(int x, int y, int z, Chunk& chunk, Direction face, const Block& block) {
+void VoxelData::AddFaceVertices(int x, int y, int z, const CornerLightCache& lights, Direction face, const Block& block,
+  std::vector<float>& vertices) {
 
   // normalize coordinates
   int subchunkY = MathUtil::Mod(y, Chunk::SUBCHUNK_HEIGHT);
-  float x0 = x, x1 = x + 1;
-  float y0 = subchunkY, y1 = subchunkY + 1;
-  float z0 = z, z1 = z + 1;
 
   const std::string& textureName = block.GetTextures()[face];
   TextureAtlas::TextureCoords tex = Blocks::GetAtlas().GetTextureCoords(textureName);
-
-  std::array<float, 4> skyCornerLights = GetCornerLightValues(x, y, z, LightType::SKY, face, chunk);
-  std::array<float, 4> blockCornerLights = GetCornerLightValues(x, y, z, LightType::BLOCK, face, chunk);
+  const float texCoords[4][2] = { {tex.x0, tex.y1}, {tex.x0, tex.y0}, {tex.x1, tex.y0}, {tex.x1, tex.y1} };
 
   // Make sure light sources are not dimmed
-  char blockLight = block.GetLightLevel();
-  if (blockLight > 0) {
-    for (float& blockCornerLight : blockCornerLights) {
-      blockCornerLight = std::max(blockCornerLight, blockLight / 15.0f);
-    }
-  }
+  float sourceLight = block.GetLightLevel() / 15.0f;
 
-  switch (face) {
-  case Direction::SOUTH: {
-    return {
-      x0, y1, z1, tex.x0, tex.y1, skyCornerLights[0], blockCornerLights[0],
-      x0, y0, z1, tex.x0, tex.y0, skyCornerLights[1], blockCornerLights[1],
-      x1, y0, z1, tex.x1, tex.y0, skyCornerLights[2], blockCornerLights[2],
-      x1, y1, z1, tex.x1, tex.y1, skyCornerLights[3], blockCornerLights[3]
-    };
-  }
-  case Direction::NORTH: {
-    return {
-      x1, y1, z0, tex.x0, tex.y1, skyCornerLights[0], blockCornerLights[0],
-      x1, y0, z0, tex.x0, tex.y0, skyCornerLights[1], blockCornerLights[1],
-      x0, y0, z0, tex.x1, tex.y0, skyCornerLights[2], blockCornerLights[2],
-      x0, y1, z0, tex.x1, tex.y1, skyCornerLights[3], blockCornerLights[3]
-    };
-  }
-  case Direction::EAST: {
-    return {
-      x1, y1, z1, tex.x0, tex.y1, skyCornerLights[0], blockCornerLights[0],
-      x1, y0, z1, tex.x0, tex.y0, skyCornerLights[1], blockCornerLights[1],
-      x1, y0, z0, tex.x1, tex.y0, skyCornerLights[2], blockCornerLights[2],
-      x1, y1, z0, tex.x1, tex.y1, skyCornerLights[3], blockCornerLights[3]
-    };
-  }
-  case Direction::WEST: {
-    return {
-      x0, y1, z0, tex.x0, tex.y1, skyCornerLights[0], blockCornerLights[0],
-      x0, y0, z0, tex.x0, tex.y0, skyCornerLights[1], blockCornerLights[1],
-      x0, y0, z1, tex.x1, tex.y0, skyCornerLights[2], blockCornerLights[2],
-      x0, y1, z1, tex.x1, tex.y1, skyCornerLights[3], blockCornerLights[3]
-    };
-  }
-  case Direction::UP: {
-    return {
-      x0, y1, z0, tex.x0, tex.y1, skyCornerLights[0], blockCornerLights[0],
-      x0, y1, z1, tex.x0, tex.y0, skyCornerLights[1], blockCornerLights[1],
-      x1, y1, z1, tex.x1, tex.y0, skyCornerLights[2], blockCornerLights[2],
-      x1, y1, z0, tex.x1, tex.y1, skyCornerLights[3], blockCornerLights[3]
-    };
-  }
-  case Direction::DOWN: {
-    return {
-      x1, y0, z0, tex.x0, tex.y1, skyCornerLights[0], blockCornerLights[0],
-      x1, y0, z1, tex.x0, tex.y0, skyCornerLights[1], blockCornerLights[1],
-      x0, y0, z1, tex.x1, tex.y0, skyCornerLights[2], blockCornerLights[2],
-      x0, y0, z0, tex.x1, tex.y1, skyCornerLights[3], blockCornerLights[3]
-    };
-  }
+  glm::ivec3 position = { x, y, z };
+  for (int i = 0; i < 4; i++) {
+    const glm::ivec3& corner = FACE_CORNERS[(int)face][i];
+
+    float skyLight;
+    float blockLight;
+    lights.GetCornerLight(position, face, position + corner, skyLight, blockLight);
+
+    vertices.insert(vertices.end(), {
+      (float)(x + corner.x), (float)(subchunkY + corner.y), (float)(z + corner.z),
+      texCoords[i][0], texCoords[i][1],
+      skyLight, std::max(blockLight, sourceLight)
+    });
   }
 }
 
@@ -145,126 +80,3 @@ const std::vector<glm::ivec3>& VoxelData::GetNeighborOffsetsAndOrigin() {
   };
   return neighborOffsets;
 }
-
-std::array<float, 4> VoxelData::GetCornerLightValues(int x, int y, int z, LightType type, Direction face, Chunk& chunk) {
-
-  /*
-  | 00 | 10 | 20 |
-  ----------------
-  | 01 | 11 | 21 |
-  ----------------
-  | 02 | 12 | 22 |
-  */
-
-  std::array<glm::ivec3, 9> offsets = GetOffset3x3(x, y, z, face);
-  if (DebugSettings::instance.smoothLighting) {
-    float l00 = chunk.GetFixedLightAt(type, XYZ(offsets[0]));
-    float l10 = chunk.GetFixedLightAt(type, XYZ(offsets[1]));
-    float l20 = chunk.GetFixedLightAt(type, XYZ(offsets[2]));
-    float l01 = chunk.GetFixedLightAt(type, XYZ(offsets[3]));
-    float l11 = chunk.GetFixedLightAt(type, XYZ(offsets[4]));
-    float l21 = chunk.GetFixedLightAt(type, XYZ(offsets[5]));
-    float l02 = chunk.GetFixedLightAt(type, XYZ(offsets[6]));
-    float l12 = chunk.GetFixedLightAt(type, XYZ(offsets[7]));
-    float l22 = chunk.GetFixedLightAt(type, XYZ(offsets[8]));
-
-    bool s10 = Block::FromBlockstate(chunk.GetBlockstateAt(XYZ(offsets[1]))).IsSolid();
-    bool s01 = Block::FromBlockstate(chunk.GetBlockstateAt(XYZ(offsets[3]))).IsSolid();
-    bool s21 = Block::FromBlockstate(chunk.GetBlockstateAt(XYZ(offsets[5]))).IsSolid();
-    bool s12 = Block::FromBlockstate(chunk.GetBlockstateAt(XYZ(offsets[7]))).IsSolid();
-
-    // Don't consider corners if they're completely blocked
-    if (s10 && s01) l00 = 0.0f;
-    if (s10 && s21) l20 = 0.0f;
-    if (s01 && s12) l02 = 0.0f;
-    if (s12 && s21) l22 = 0.0f;
-
-    return {
-      NormalizeAmbientLighting(l00, l10, l01, l11),
-      NormalizeAmbientLighting(l01, l11, l02, l12),
-      NormalizeAmbientLighting(l11, l21, l12, l22),
-      NormalizeAmbientLighting(l10, l20, l11, l21)
-    };
-  }
-
-  float centerLight = chunk.GetFixedLightAt(type, XYZ(offsets[4]));
-
-  return { centerLight, centerLight, centerLight, centerLight };
-}
-
-std::array<glm::ivec3, 9> VoxelData::GetOffset3x3(int x, int y, int z, Direction face) {
-  switch (face) {
-  case Direction::SOUTH:
-    return {
-      glm::ivec3{x - 1, y + 1, z + 1},
-      glm::ivec3{x + 0, y + 1, z + 1},
-      glm::ivec3{x + 1, y + 1, z + 1},
-      glm::ivec3{x - 1, y + 0, z + 1},
-      glm::ivec3{x + 0, y + 0, z + 1},
-      glm::ivec3{x + 1, y + 0, z + 1},
-      glm::ivec3{x - 1, y - 1, z + 1},
-      glm::ivec3{x + 0, y - 1, z + 1},
-      glm::ivec3{x + 1, y - 1, z + 1}
-    };
-  case Direction::NORTH:
-    return {
-      glm::ivec3{x + 1, y + 1, z - 1},
-      glm::ivec3{x + 0, y + 1, z - 1},
-      glm::ivec3{x - 1, y + 1, z - 1},
-      glm::ivec3{x + 1, y + 0, z - 1},
-      glm::ivec3{x + 0, y + 0, z - 1},
-      glm::ivec3{x - 1, y + 0, z - 1},
-      glm::ivec3{x + 1, y - 1, z - 1},
-      glm::ivec3{x + 0, y - 1, z - 1},
-      glm::ivec3{x - 1, y - 1, z - 1}
-    };
-  case Direction::EAST:
-    return {
-      glm::ivec3{x + 1, y + 1, z + 1},
-      glm::ivec3{x + 1, y + 1, z + 0},
-      glm::ivec3{x + 1, y + 1, z - 1},
-      glm::ivec3{x + 1, y + 0, z + 1},
-      glm::ivec3{x + 1, y + 0, z + 0},
-      glm::ivec3{x + 1, y + 0, z - 1},
-      glm::ivec3{x + 1, y - 1, z + 1},
-      glm::ivec3{x + 1, y - 1, z + 0},
-      glm::ivec3{x + 1, y - 1, z - 1}
-    };
-  case Direction::WEST:
-    return {
-      glm::ivec3{x - 1, y + 1, z - 1},
-      glm::ivec3{x - 1, y + 1, z + 0},
-      glm::ivec3{x - 1, y + 1, z + 1},
-      glm::ivec3{x - 1, y + 0, z - 1},
-      glm::ivec3{x - 1, y + 0, z + 0},
-      glm::ivec3{x - 1, y + 0, z + 1},
-      glm::ivec3{x - 1, y - 1, z - 1},
-      glm::ivec3{x - 1, y - 1, z + 0},
-      glm::ivec3{x - 1, y - 1, z + 1}
-    };
-  case Direction::UP:
-    return {
-      glm::ivec3 { x - 1, y + 1, z - 1 },
-        glm::ivec3 { x + 0, y + 1, z - 1 },
-        glm::ivec3 { x + 1, y + 1, z - 1 },
-        glm::ivec3 { x - 1, y + 1, z + 0 },
-        glm::ivec3 { x + 0, y + 1, z + 0 },
-        glm::ivec3 { x + 1, y + 1, z + 0 },
-        glm::ivec3 { x - 1, y + 1, z + 1 },
-        glm::ivec3 { x + 0, y + 1, z + 1 },
-        glm::ivec3 { x + 1, y + 1, z + 1 }
-    };
-  case Direction::DOWN:
-    return {
-      glm::ivec3{x + 1, y - 1, z - 1},
-      glm::ivec3{x + 0, y - 1, z - 1},
-      glm::ivec3{x - 1, y - 1, z - 1},
-      glm::ivec3{x + 1, y - 1, z + 0},
-      glm::ivec3{x + 0, y - 1, z + 0},
-      glm::ivec3{x - 1, y - 1, z + 0},
-      glm::ivec3{x + 1, y - 1, z + 1},
-      glm::ivec3{x + 0, y - 1, z + 1},
-      glm::ivec3{x - 1, y - 1, z + 1}
-    };
-  }
-}
@@ -4,20 +4,19 @@
 #include <glm/vec3.hpp>
 
 #include "Direction.h"
+#include "CornerLightCache.h"
 #include "../block/Block.h"
-#include "rendering/textures/TextureAtlas.h"
+#include "assets/TextureAtlas.h"
 #include "../world/Chunk.h"
 
 class Chunk;
 
 class VoxelData {
 public:
-  static std::vector<float> GetFaceVertices(int x, int y, int z, Chunk& chunk, Direction face, const Block& block);
+  // Appends the 4 vertices of the face, lit from the cache
+  static void AddFaceVertices(int x, int y, int z, const CornerLightCache& lights, Direction face, const Block& block,
+    std::vector<float>& vertices);
   static glm::ivec3 GetFaceOffset(Direction face);
 
   static const std::vector<glm::ivec3>& GetNeighborOffsetsAndOrigin();
-
-private:
-  static std::array<float, 4> GetCornerLightValues(int x, int y, int z, LightType type, Direction face, Chunk& chunk);
-  static std::array<glm::ivec3, 9> GetOffset3x3(int x, int y, int z, Direction face);
 };
\ No newline at end of file
@@ -1,17 +1,20 @@
 #include "Chunk.h"
 
-#include <glm/gtc/matrix_transform.hpp>
 #include <unordered_set>
+#include <algorithm>
+#include <tuple>
 
 #include "util/Logging.h"
 #include "util/Noise.h"
 #include "util/MathUtil.h"
-#include "rendering/Shader.h"
 #include "../voxel/Direction.h"
 #include "../voxel/VoxelData.h"
+#include "../voxel/CornerLightCache.h"
 #include "World.h"
 #include "../debug/DebugSettings.h"
 #include "util/DebugMacros.h"
+#include "util/Compression.h"
+#include "util/threadsafe/TaskPool.h"
 
 #include "../init/Blocks.h"
 #include "../block/Block.h"
@@ -20,9 +23,52 @@ const int Chunk::SUBCHUNK_HEIGHT = 16;
 const int Chunk::SUBCHUNK_LAYERS = 16;
 const int Chunk::CHUNK_WIDTH = 16;
 const int Chunk::CHUNK_HEIGHT = Chunk::SUBCHUNK_HEIGHT * Chunk::SUBCHUNK_LAYERS;
+const int Chunk::PARALLEL_GENERATION_SLABS = 4;
 
 namespace {
 const int CHUNK_VOLUME = Chunk::CHUNK_WIDTH * Chunk::CHUNK_HEIGHT * Chunk::CHUNK_WIDTH;
+// Version 1 payloads only had the snapshot data
+const unsigned char CHUNK_PAYLOAD_VERSION = 2;
+
+enum ChunkPayloadKind : unsigned char {
+  SNAPSHOT = 0,
+  DELTA = 1
+};
+
+const size_t BLOCK_EDIT_SIZE = 3;
+
+// Sky light is kept in the low bits of SkyBlockLight
+const unsigned char SKY_LIGHT_MASK = 0b00001111;
+
+// Position, texture coordinates, sky light and block light of 4 vertices
+const int FLOATS_PER_QUAD = 4 * 7;
+const int INDICES_PER_QUAD = 6;
+
+// Buffer size for a patchable subchunk, with room for a quarter more quads and at least 64
+size_t WithSpareRoom(size_t size, int perQuad) {
+  return size * 5 / 4 + 64 * perQuad;
+}
+
+void AppendQuadIndices(std::vector<unsigned int>& indices, int firstQuad, int count) {
+  for (int quad = firstQuad; quad < firstQuad + count; quad++) {
+    // Indices: 0, 1, 2, 2, 3, 0
+    unsigned int vertex = quad * 4;
+    indices.insert(indices.end(), { vertex + 0, vertex + 1, vertex + 2, vertex + 2, vertex + 3, vertex + 0 });
+  }
+}
+
+// The mesher works on columns of the subchunk and one cell around it, bit k holding the cell k - 1 above the bottom
+const int MESH_COLUMNS = Chunk::CHUNK_WIDTH + 2;
+const uint32_t MESH_COLUMN_INNER_BITS = ((1u << Chunk::SUBCHUNK_HEIGHT) - 1) << 1;
+
+// A light volume covers a subchunk and one cell around it
+const int LIGHT_VOLUME_SIZE = 18;
+
+const unsigned char TERRAIN_CACHE_VERSION = 1;
+
+// Chunk offset of each neighbor, in the order of GetNeighborIndex
+const glm::ivec2 NEIGHBOR_OFFSETS[8] = { {-1, -1}, {0, -1}, {1, -1}, {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0} };
+static_assert(sizeof(SkyBlockLight) == 1, "Lights are cached as raw bytes");
 }  // namespace
 
 Chunk::Chunk(glm::ivec2 chunkCoord, World& world) :
@@ -30,7 +76,7 @@ Chunk::Chunk(glm::ivec2 chunkCoord, World& world) :
   m_chunkCoord(chunkCoord),
   m_blockstates(std::make_unique<Blockstate[]>(CHUNK_VOLUME)),
   m_lights(std::make_unique<SkyBlockLight[]>(CHUNK_VOLUME)),
-  m_subchunkMeshes(SUBCHUNK_LAYERS), m_world(world) {}
+  m_world(world) {}
 
 
 void Chunk::GenerateMesh() {
@@ -49,14 +95,33 @@ void Chunk::GenerateMesh() {
 }
 
 void Chunk::PropagateLighting() {
-  for (int x = 0; x < CHUNK_WIDTH; x++) {
-    for (int y = 0; y < CHUNK_HEIGHT; y++) {
-      for (int z = 0; z < CHUNK_WIDTH; z++) {
-        char skyLight = GetLightAt(LightType::SKY, x, y, z);
-        if (skyLight > 0) LightSpreadingDFS(LightType::SKY, x, y, z, skyLight);
+  LightLock lock = LockLights(1);
+
+  if (m_loadedFromCache) {
+    // Cached lights are already spread inside the chunk, only the light crossing the border is missing
+    for (int x = 0; x < CHUNK_WIDTH; x++) {
+      for (int y = 0; y < CHUNK_HEIGHT; y++) {
+        for (int z = 0; z < CHUNK_WIDTH; z++) {
+          bool isBorder = x == 0 || x == CHUNK_WIDTH - 1 || z == 0 || z == CHUNK_WIDTH - 1;
+          if (!isBorder) continue;
+
+          char skyLight = GetLightAt(LightType::SKY, x, y, z);
+          if (skyLight > 0) LightSpreadingDFS(LightType::SKY, x, y, z, skyLight);
+
+          char blockLight = GetLightAt(LightType::BLOCK, x, y, z);
+          if (blockLight > 0) LightSpreadingDFS(LightType::BLOCK, x, y, z, blockLight);
+        }
+      }
+    }
+  } else {
+    SpreadSkyLight();
 
-        char blockLight = GetLightAt(LightType::BLOCK, x, y, z);
-        if (blockLight > 0) LightSpreadingDFS(LightType::BLOCK, x, y, z, blockLight);
+    for (int x = 0; x < CHUNK_WIDTH; x++) {
+      for (int y = 0; y < CHUNK_HEIGHT; y++) {
+        for (int z = 0; z < CHUNK_WIDTH; z++) {
+          char blockLight = m_lights[PosToIndex(x, y, z)].GetLight(LightType::BLOCK);
+          if (blockLight > 0) LightSpreadingDFS(LightType::BLOCK, x, y, z, blockLight);
+        }
       }
     }
   }
@@ -68,6 +133,9 @@ void Chunk::PropagateLighting() {
 }
 
 void Chunk::PropagateLightingAtPos(glm::ivec3 localPosition, Blockstate oldBlockstate, Blockstate newBlockstate) {
+  // The light removed around the position is spread again from up to 15 blocks away
+  LightLock lock = LockLights(2);
+
   char oldSkyLight = GetLightAt(LightType::SKY, XYZ(localPosition));
   char oldBlockLight = GetLightAt(LightType::BLOCK, XYZ(localPosition));
 
@@ -110,19 +178,135 @@ void Chunk::PropagateLightingAtPos(glm::ivec3 localPosition, Blockstate oldBlock
     LightUpdatingDFS(LightType::BLOCK, XYZ(localPosition));
   }
 
+  for (const std::shared_ptr<Chunk>& chunk : lock.chunks) {
+    chunk->FlushLightDirty();
+  }
 }
 
 void Chunk::FillSkyLight() {
+  m_skyHeights.resize(CHUNK_WIDTH * CHUNK_WIDTH);
+  unsigned char* lights = reinterpret_cast<unsigned char*>(m_lights.get());
+
   for (int x = 0; x < CHUNK_WIDTH; x++) {
+    int lowestSky = CHUNK_HEIGHT;
+    int highestSky = 0;
     for (int z = 0; z < CHUNK_WIDTH; z++) {
-      for (int y = CHUNK_HEIGHT - 1; y >= 0; y--) {
-        if (Block::FromBlockstate(m_blockstates[PosToIndex(x, y, z)]).IsSolid()) break;
-        m_lights[PosToIndex(x, y, z)].SetLight(LightType::SKY, 15);
+      int y = CHUNK_HEIGHT;
+      while (y > 0 && !Block::FromBlockstate(m_blockstates[PosToIndex(x, y - 1, z)]).IsSolid()) y--;
+
+      m_skyHeights[x * CHUNK_WIDTH + z] = y;
+      lowestSky = std::min(lowestSky, y);
+      highestSky = std::max(highestSky, y);
+    }
+
+    // An x layer is stored row after row, so above its highest column the open sky is a single span
+    unsigned char* layer = lights + PosToIndex(x, 0, 0);
+    for (int i = highestSky * CHUNK_WIDTH; i < CHUNK_HEIGHT * CHUNK_WIDTH; i++) {
+      layer[i] |= SKY_LIGHT_MASK;
+    }
+
+    for (int y = lowestSky; y < highestSky; y++) {
+      for (int z = 0; z < CHUNK_WIDTH; z++) {
+        if (y >= m_skyHeights[x * CHUNK_WIDTH + z]) layer[y * CHUNK_WIDTH + z] |= SKY_LIGHT_MASK;
       }
     }
   }
 }
 
+Chunk::LightLock Chunk::LockLights(int radius) {
+  LightLock lock;
+  for (int x = -radius; x <= radius; x++) {
+    for (int z = -radius; z <= radius; z++) {
+      std::shared_ptr<Chunk> chunk = (x == 0 && z == 0) ? shared_from_this() : m_world.GetChunkAt(m_chunkCoord + glm::ivec2(x, z));
+      if (chunk) lock.chunks.push_back(std::move(chunk));
+    }
+  }
+
+  // An unloaded chunk can still be alive next to its replacement, so the address breaks ties
+  std::sort(lock.chunks.begin(), lock.chunks.end(), [](const std::shared_ptr<Chunk>& a, const std::shared_ptr<Chunk>& b) {
+    return std::make_tuple(a->m_chunkCoord.x, a->m_chunkCoord.y, a.get()) < std::make_tuple(b->m_chunkCoord.x, b->m_chunkCoord.y, b.get());
+  });
+
+  for (const std::shared_ptr<Chunk>& chunk : lock.chunks) {
+    lock.locks.emplace_back(chunk->m_lightMutex);
+  }
+  return lock;
+}
+
+void Chunk::SpreadSkyLight() {
+  // Sky light fades out within a chunk's width, so it can't go past the neighbors
+  std::array<std::shared_ptr<Chunk>, 8> neighbors;
+  for (int i = 0; i < 8; i++) {
+    neighbors[i] = GetNeighbor(NEIGHBOR_OFFSETS[i].x * CHUNK_WIDTH, NEIGHBOR_OFFSETS[i].y * CHUNK_WIDTH);
+  }
+  auto chunkAt = [&](int localX, int localZ) {
+    return IsInOtherChunk(localX, 0, localZ) ? neighbors[GetNeighborIndex(localX, localZ)].get() : this;
+  };
+
+  static const glm::ivec2 sideOffsets[] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+
+  std::vector<glm::ivec3> frontier;
+  for (int x = 0; x < CHUNK_WIDTH; x++) {
+    for (int z = 0; z < CHUNK_WIDTH; z++) {
+      int skyHeight = m_skyHeights[x * CHUNK_WIDTH + z];
+      // Light above and below the open sky can't change anything, only the rows next to a darker column are seeds
+      int seedTop = skyHeight;
+
+      for (const glm::ivec2& offset : sideOffsets) {
+        int sideX = x + offset.x;
+        int sideZ = z + offset.y;
+        if (!IsInOtherChunk(sideX, 0, sideZ)) {
+          seedTop = std::max(seedTop, m_skyHeights[sideX * CHUNK_WIDTH + sideZ]);
+          continue;
+        }
+
+        // The neighbor could have been lit already, so look for its highest open cell still missing light
+        Chunk* neighbor = chunkAt(sideX, sideZ);
+        if (neighbor == nullptr) continue;
+
+        glm::ivec3 neighborCoords = ToNeighborCoords(sideX, 0, sideZ);
+        for (int y = CHUNK_HEIGHT - 1; y >= seedTop; y--) {
+          int index = PosToIndex(neighborCoords.x, y, neighborCoords.z);
+          if (neighbor->m_lights[index].GetLight(LightType::SKY) < 14 && !Block::FromBlockstate(neighbor->m_blockstates[index]).IsSolid()) {
+            seedTop = y + 1;
+            break;
+          }
+        }
+      }
+
+      for (int y = skyHeight; y < seedTop; y++) {
+        frontier.push_back({ x, y, z });
+      }
+    }
+  }
+
+  // Every seed starts at full light, so spreading them a level at a time sets each cell once instead of raising it
+  // again for every seed that reaches it
+  static const glm::ivec3 spreadDirections[] = { {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1} };
+  std::vector<glm::ivec3> nextFrontier;
+  for (char value = 14; value > 0 && !frontier.empty(); value--) {
+    for (const glm::ivec3& position : frontier) {
+      for (const glm::ivec3& offset : spreadDirections) {
+        glm::ivec3 next = position + offset;
+        if (next.y < 0 || next.y >= CHUNK_HEIGHT) continue;
+
+        Chunk* chunk = chunkAt(next.x, next.z);
+        if (chunk == nullptr) continue;
+
+        int index = PosToIndex(ToNeighborCoords(XYZ(next)));
+        SkyBlockLight& light = chunk->m_lights[index];
+        if (light.GetLight(LightType::SKY) >= value || Block::FromBlockstate(chunk->m_blockstates[index]).IsSolid()) continue;
+
+        light.SetLight(LightType::SKY, value);
+        nextFrontier.push_back(next);
+      }
+    }
+
+    std::swap(frontier, nextFrontier);
+    nextFrontier.clear();
+  }
+}
+
 // This DFS will spread light values to adjacent blocks
 void Chunk::LightSpreadingDFS(LightType type, int x, int y, int z, char value, bool markDirty) {
   if (value <= 0) return;
@@ -138,7 +322,7 @@ void Chunk::LightSpreadingDFS(LightType type, int x, int y, int z, char value, b
   }
 
   SetLightAt(type, x, y, z, value);
-  if (markDirty) MarkPositionAndAllNeighborsDirty({ x, y, z });
+  if (markDirty) MarkLightDirty({ x, y, z });
 
   static glm::ivec3 spreadDirections[] = { {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1} };
   for (const glm::ivec3& offset : spreadDirections) {
@@ -193,7 +377,7 @@ void Chunk::LightUpdatingDFS(LightType type, int x, int y, int z) {
   // spread the light change
   if (maxLight != startingLight) {
     SetLightAt(type, x, y, z, maxLight);
-    MarkPositionAndAllNeighborsDirty({ x, y, z });
+    MarkLightDirty({ x, y, z });
     for (const glm::ivec3& offset : spreadDirections) {
       int newX = x + offset.x;
       int newY = y + offset.y;
@@ -223,7 +407,7 @@ void Chunk::LightRemovingDFS(LightType type, int x, int y, int z, char value, ch
   }
 
   SetLightAt(type, x, y, z, value);
-  MarkPositionAndAllNeighborsDirty({ x, y, z });
+  MarkLightDirty({ x, y, z });
 
   static glm::ivec3 spreadDirections[] = { {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1} };
 
@@ -307,12 +491,16 @@ std::shared_ptr<Chunk> Chunk::GetNeighbor(int localX, int localZ) {
 }
 
 void Chunk::ApplyMesh() {
-  for (int i = 0; i < SUBCHUNK_LAYERS; i++) {
-    std::vector<float>& vertices = m_subchunkMeshesData[i].vertices;
-    std::vector<unsigned int>& indices = m_subchunkMeshesData[i].indices;
+  if (m_subchunkMeshes.empty()) m_subchunkMeshes.resize(SUBCHUNK_LAYERS * RENDER_LAYER_COUNT);
+  if (m_lightVolumes.empty()) m_lightVolumes.resize(SUBCHUNK_LAYERS);
 
-    m_subchunkMeshes[i].SetData(vertices.data(), vertices.size(), indices.data(), indices.size());
+  for (int i = 0; i < SUBCHUNK_LAYERS; i++) {
+    for (int layer = 0; layer < RENDER_LAYER_COUNT; layer++) {
+      UploadLayer(i, (RenderLayer)layer, /*spareRoom=*/false);
+    }
+    ApplyLightVolume(i);
   }
+  SortTranslucentQuads(m_world.GetTranslucentSortEye());
 
   m_subchunkMeshesData.resize(Chunk::SUBCHUNK_LAYERS, {});
   {
@@ -321,141 +509,767 @@ void Chunk::ApplyMesh() {
   }
 }
 
-void Chunk::GenerateTerrain() {
+void Chunk::GenerateTerrain(bool parallel) {
+  GenerateBlocks(parallel);
+  PlaceStructures(/*writeInside=*/true);
+
+  {
+    std::lock_guard<std::mutex> lock(m_stateMutex);
+    m_state = GENERATED_STRUCTURES;
+  }
+}
+
+void Chunk::FinishTerrain() {
+  // Only leaves reach into other chunks, so the order the neighbors are merged in doesn't matter
+  for (int i = 0; i < 8; i++) {
+    std::shared_ptr<Chunk> neighbor = GetNeighbor(NEIGHBOR_OFFSETS[i].x * CHUNK_WIDTH, NEIGHBOR_OFFSETS[i].y * CHUNK_WIDTH);
+    if (neighbor == nullptr) continue;
+
+    // The neighbor sees this chunk from the opposite side
+    for (const BlockEdit& write : neighbor->GetStructureWrites((i + 4) % 8)) {
+      m_blockstates[write.index] = write.blockstate;
+    }
+  }
+
+  // Edits loaded from a delta payload go over the finished terrain
+  for (const BlockEdit& edit : m_edits) {
+    m_blockstates[edit.index] = edit.blockstate;
+  }
+
+  RecalculateLights();
+
+  {
+    std::lock_guard<std::mutex> lock(m_stateMutex);
+    m_state = GENERATED_TERRAIN;
+  }
+}
+
+const std::vector<BlockEdit>& Chunk::GetStructureWrites(int neighborIndex) const {
+  return m_structureWrites[neighborIndex];
+}
+
+void Chunk::GenerateBlocks(bool parallel) {
+  if (m_heightmap.empty()) GenerateHeightmap();
+
+  bool carveCaves = m_caveMask.empty();
+  if (carveCaves) m_caveMask.assign(CHUNK_VOLUME / 64, 0);
+
+  // Every slab samples its own noise on the thread running it. The noise lattices are aligned to the world, so the
+  // blocks are the same however the chunk is split
+  TaskPool& pool = TaskPool::GetInstance();
+  int slabCount = parallel && pool.GetHelperCount() > 0 ? PARALLEL_GENERATION_SLABS : 1;
+  int slabWidth = CHUNK_WIDTH / slabCount;
+  pool.ParallelFor(slabCount, [&](int slab) {
+    int firstX = slab * slabWidth;
+    int endX = firstX + slabWidth;
+
+    if (carveCaves) CarveCaves(firstX, endX);
+    Sculpt(firstX, endX);
+    Paint(firstX, endX);
+  });
+}
+
+void Chunk::ResetGeneration(GenerationStage firstStage) {
+  if (firstStage <= GenerationStage::HEIGHTMAP) m_heightmap.clear();
+  if (firstStage <= GenerationStage::SCULPT) m_caveMask.clear();
+
+  m_regenerating = true;
+  // Cached lights are gone too
+  m_loadedFromCache = false;
+  m_dirtySubchunks = 0;
+  m_dirtyLightVolumes = 0;
+  m_patchSubchunks = 0;
+  m_patchPositions.clear();
+  m_hasLightDirty = false;
+
+  m_queuedGeneration = false;
+  a_queuedTerrain = false;
+  a_queuedFinish = false;
+  a_queuedLighting = false;
+  a_queuedMesh = false;
+
+  std::lock_guard<std::mutex> lock(m_stateMutex);
+  m_state = INITIALIZED;
+}
+
+bool Chunk::IsRegenerating() const {
+  return m_regenerating;
+}
+
+void Chunk::RegenerateTerrain(bool parallel) {
+  m_regenerating = false;
+
+  if (!m_compacted) {
+    GenerateTerrain(parallel);
+    return;
+  }
+
+  // The player's blocks stay, only the structures this chunk places in its neighbors and the lights can change
+  if (m_heightmap.empty()) GenerateHeightmap();
+  PlaceStructures(/*writeInside=*/false);
+  RecalculateLights();
+
+  std::lock_guard<std::mutex> lock(m_stateMutex);
+  m_state = GENERATED_TERRAIN;
+}
+
+void Chunk::GenerateHeightmap() {
+  m_heightmap.resize(CHUNK_WIDTH * CHUNK_WIDTH);
+  m_world.GetGenerator().SampleHeightmap(WorldGenerator::GetThreadContext(), m_chunkCoord.x * CHUNK_WIDTH, m_chunkCoord.y * CHUNK_WIDTH, CHUNK_WIDTH, CHUNK_WIDTH, m_heightmap.data());
+}
+
+int Chunk::GetSampleHeight(int firstX, int endX) const {
+  auto first = m_heightmap.begin() + firstX * CHUNK_WIDTH;
+  auto last = m_heightmap.begin() + endX * CHUNK_WIDTH;
+  return std::clamp(*std::max_element(first, last) + 1, 1, CHUNK_HEIGHT);
+}
 
+void Chunk::CarveCaves(int firstX, int endX) {
   int x0 = m_chunkCoord.x * CHUNK_WIDTH;
   int z0 = m_chunkCoord.y * CHUNK_WIDTH;
 
-  const DebugSettings& settings = DebugSettings::instance;
+  const WorldGenerator& generator = m_world.GetGenerator();
+  WorldGenerator::Context& context = WorldGenerator::GetThreadContext();
 
-  for (int x = 0; x < CHUNK_WIDTH; x++) {
+  // Caves can carve anything from y = 2 up to the surface
+  generator.SampleCaves(context, x0 + firstX, 0, z0, endX - firstX, GetSampleHeight(firstX, endX), CHUNK_WIDTH);
+
+  // A whole x layer fills whole words of the mask, so slabs never write the same word
+  for (int x = firstX; x < endX; x++) {
     for (int z = 0; z < CHUNK_WIDTH; z++) {
+      int terrainHeight = std::min(m_heightmap[x * CHUNK_WIDTH + z], CHUNK_HEIGHT - 1);
 
-      // (X, Z) calculations
-      double noiseValue = Noise::Noise2D(x0 + x, z0 + z, settings.noiseOffsets[0], settings.noiseOffsets[1], settings.noiseScale, settings.octaves, settings.persistence, settings.lacunarity);
-      int terrainDifference = MathUtil::FloorToInt(MathUtil::Map(noiseValue, -1, 1, settings.terrainRange[0], settings.terrainRange[1]));
-      int terrainHeight = settings.baseTerrainHeight + terrainDifference;
+      for (int y = 2; y <= terrainHeight; y++) {
+        if (generator.IsCave(context, x0 + x, y, z0 + z)) {
+          int index = PosToIndex(x, y, z);
+          m_caveMask[index / 64] |= 1ULL << (index % 64);
+        }
+      }
+    }
+  }
+}
 
-      double treeValue = Noise::RandomNoise2D(x0 + x, z0 + z, 0, 0);
+void Chunk::Sculpt(int firstX, int endX) {
+  for (int x = firstX; x < endX; x++) {
+    for (int z = 0; z < CHUNK_WIDTH; z++) {
+      int terrainHeight = m_heightmap[x * CHUNK_WIDTH + z];
 
       for (int y = 0; y < CHUNK_HEIGHT; y++) {
+        int index = PosToIndex(x, y, z);
+        Blockstate blockstate;
 
-        char blockstate;
-
-        // TERRAIN PASS
         if (y > terrainHeight) {
           blockstate = Blocks::AIR;
-        } else if (y == terrainHeight) {
+        } else if (y == 0) {
+          blockstate = Blocks::BEDROCK;
+        } else if (m_caveMask[index / 64] & (1ULL << (index % 64))) {
+          blockstate = Blocks::CAVE_AIR;
+        } else {
+          blockstate = Blocks::STONE;
+        }
+
+        m_blockstates[index] = blockstate;
+      }
+    }
+  }
+}
+
+void Chunk::Paint(int firstX, int endX) {
+  int x0 = m_chunkCoord.x * CHUNK_WIDTH;
+  int z0 = m_chunkCoord.y * CHUNK_WIDTH;
+
+  const WorldGenerator& generator = m_world.GetGenerator();
+  WorldGenerator::Context& context = WorldGenerator::GetThreadContext();
+
+  generator.SampleOres(context, x0 + firstX, 0, z0, endX - firstX, GetSampleHeight(firstX, endX), CHUNK_WIDTH);
+
+  for (int x = firstX; x < endX; x++) {
+    for (int z = 0; z < CHUNK_WIDTH; z++) {
+      int terrainHeight = m_heightmap[x * CHUNK_WIDTH + z];
+
+      // Only the stone left by the sculpt stage gets painted
+      for (int y = 1; y <= std::min(terrainHeight, CHUNK_HEIGHT - 1); y++) {
+        Blockstate& blockstate = m_blockstates[PosToIndex(x, y, z)];
+        if (blockstate != Blocks::STONE) continue;
+
+        if (y == terrainHeight) {
           blockstate = Blocks::GRASS;
         } else if (y > terrainHeight - 3) {
           blockstate = Blocks::DIRT;
-        } else if (y > 0) {
-          blockstate = Blocks::STONE;
         } else {
-          blockstate = Blocks::BEDROCK;
+          blockstate = generator.GetOre(context, x0 + x, y, z0 + z);
         }
+      }
+    }
+  }
+}
 
-        // CAVE PASS
-        if (blockstate != Blocks::AIR && y >= 2) {
-          double caveNoiseValue = (Noise::Noise3D(x0 + x, y, z0 + z, settings.caveNoiseOffsets[0], settings.caveNoiseOffsets[1], settings.caveNoiseOffsets[2], settings.caveNoiseScale) + 1.0) / 2.0;
-          if (caveNoiseValue < settings.caveThreshold) {
-            blockstate = Blocks::CAVE_AIR;
-          }
-        }
+void Chunk::PlaceStructures(bool writeInside) {
+  for (std::vector<BlockEdit>& writes : m_structureWrites) {
+    writes.clear();
+  }
 
-        // ORE PASS
-        if (blockstate == Blocks::STONE) {
-          double coalNoiseValue = (Noise::Noise3D(x0 + x, y, z0 + z, 1000, 1000, 1000, settings.coalScale) + 1.0) / 2.0;
-          if (coalNoiseValue < settings.coalThreshold) {
-            blockstate = Blocks::COAL_ORE;
-          }
+  int x0 = m_chunkCoord.x * CHUNK_WIDTH;
+  int z0 = m_chunkCoord.y * CHUNK_WIDTH;
 
-          double ironNoiseValue = (Noise::Noise3D(x0 + x, y, z0 + z, 2000, 2000, 1000, settings.ironScale) + 1.0) / 2.0;
-          if (ironNoiseValue < settings.ironThreshold) {
-            blockstate = Blocks::IRON_ORE;
-          }
-        }
+  for (int x = 0; x < CHUNK_WIDTH; x++) {
+    for (int z = 0; z < CHUNK_WIDTH; z++) {
+      int y = m_heightmap[x * CHUNK_WIDTH + z] + 1;
+      if (y >= CHUNK_HEIGHT || Noise::RandomNoise2D(x0 + x, z0 + z, 0, 0) >= 0.01 || !HasGrassSurface(x, z)) continue;
+
+      int treeHeight = MathUtil::IntLerp(5, 9, Noise::RandomNoise2D(x, z, 1000, 1000));
+
+      SetStructureBlock(x, y - 1, z, Blocks::DIRT, writeInside);
+      for (int i = 0; i < treeHeight; i++) {
+        SetStructureBlock(x, y + i, z, Blocks::OAK_LOG, writeInside);
+      }
 
-        // TREE PASS (Structure)
-        // TODO: Change to a sculpting -> structures -> painting terrain generation
-        // This will enable just sculpting to be performed when adding structures
-        // Also, create a more robust structure system (with objects)
-        if (y == terrainHeight + 1 && m_blockstates[PosToIndex(x, terrainHeight, z)] == Blocks::GRASS) {
-          if (treeValue < 0.01) {
-            m_treeLocations.push_back({ x, y, z });
+      for (int dx = -2; dx <= 2; dx++) {
+        for (int dy = -2; dy <= 2; dy++) {
+          for (int dz = -2; dz <= 2; dz++) {
+            if (dx == 0 && dz == 0 && dy < 0) continue;
+            SetStructureBlock(x + dx, y + dy + treeHeight, z + dz, Blocks::OAK_LEAVES, writeInside);
           }
         }
-
-        m_blockstates[PosToIndex(x, y, z)] = blockstate;
-        m_lights[PosToIndex(x, y, z)].SetLight(LightType::BLOCK, Block::FromBlockstate(blockstate).GetLightLevel());
       }
     }
   }
+}
 
-  SpawnTrees();
+bool Chunk::HasGrassSurface(int localX, int localZ) const {
+  int terrainHeight = m_heightmap[localX * CHUNK_WIDTH + localZ];
+  if (terrainHeight < 1 || terrainHeight >= CHUNK_HEIGHT) return false;
+  if (terrainHeight < 2) return true;
 
-  FillSkyLight();
+  // Loaded chunks don't have their generated blocks, so check whether a cave carved the grass away by sampling the
+  // cave noise on its own, which gives the same value as the sculpt stage
+  glm::ivec3 global = ToGlobalCoords(localX, terrainHeight, localZ);
+  return !m_world.GetGenerator().IsCaveAt(WorldGenerator::GetThreadContext(), global.x, global.y, global.z);
+}
+
+void Chunk::SetStructureBlock(int localX, int localY, int localZ, Blockstate blockstate, bool writeInside) {
+  if (localY < 0 || localY >= CHUNK_HEIGHT) return;
+
+  if (IsInOtherChunk(localX, localY, localZ)) {
+    glm::ivec3 neighborCoords = ToNeighborCoords(localX, localY, localZ);
+    m_structureWrites[GetNeighborIndex(localX, localZ)].push_back({ (uint16_t)PosToIndex(neighborCoords), blockstate });
+  } else if (writeInside) {
+    m_blockstates[PosToIndex(localX, localY, localZ)] = blockstate;
+  }
+}
+
+bool Chunk::LoadTerrain(const std::vector<unsigned char>& payload) {
+  if (payload.empty()) return false;
+
+  unsigned char version = payload[0];
+  const unsigned char* data = payload.data() + 1;
+  size_t size = payload.size() - 1;
+
+  ChunkPayloadKind kind = SNAPSHOT;
+  if (version == CHUNK_PAYLOAD_VERSION) {
+    if (size == 0) return false;
+    kind = (ChunkPayloadKind)data[0];
+    data++;
+    size--;
+  } else if (version != 1) {
+    return false;
+  }
+
+  if (kind == SNAPSHOT) {
+    if (!Compression::RunLengthDecode(data, size, m_blockstates.get(), CHUNK_VOLUME)) return false;
+    m_compacted = true;
+
+    // The snapshot already has every structure, the neighbors still need the parts of this chunk's
+    GenerateHeightmap();
+    PlaceStructures(/*writeInside=*/false);
+    RecalculateLights();
+
+    std::lock_guard<std::mutex> lock(m_stateMutex);
+    m_state = GENERATED_TERRAIN;
+    return true;
+  } else if (kind == DELTA) {
+    if (size % BLOCK_EDIT_SIZE != 0) return false;
+
+    std::vector<BlockEdit> edits(size / BLOCK_EDIT_SIZE);
+    for (size_t i = 0; i < edits.size(); i++) {
+      const unsigned char* bytes = data + i * BLOCK_EDIT_SIZE;
+      edits[i] = { (uint16_t)(bytes[0] | (bytes[1] << 8)), bytes[2] };
+    }
+
+    // Generation is deterministic, so regenerating the chunk and replaying the edits in FinishTerrain gives back the
+    // saved chunk
+    m_edits = std::move(edits);
+    GenerateTerrain();
+    return true;
+  }
+
+  return false;
+}
+
+std::vector<unsigned char> Chunk::Serialize() const {
+  std::vector<unsigned char> payload = { CHUNK_PAYLOAD_VERSION };
+
+  if (m_compacted) {
+    payload.push_back(SNAPSHOT);
+    Compression::RunLengthEncode(m_blockstates.get(), CHUNK_VOLUME, payload);
+  } else {
+    payload.push_back(DELTA);
+    payload.reserve(payload.size() + m_edits.size() * BLOCK_EDIT_SIZE);
+    for (const BlockEdit& edit : m_edits) {
+      payload.push_back(edit.index & 0xFF);
+      payload.push_back(edit.index >> 8);
+      payload.push_back(edit.blockstate);
+    }
+  }
+
+  return payload;
+}
+
+void Chunk::RecordEdit(glm::ivec3 localPosition, Blockstate blockstate) {
+  a_modified = true;
+  if (m_compacted) return;
+
+  uint16_t index = (uint16_t)PosToIndex(localPosition);
+
+  // Only the last edit at a position matters
+  auto it = std::find_if(m_edits.begin(), m_edits.end(), [&](const BlockEdit& edit) { return edit.index == index; });
+  if (it != m_edits.end()) {
+    it->blockstate = blockstate;
+  } else {
+    m_edits.push_back({ index, blockstate });
+  }
+
+  // A big log is not worth replaying anymore, save the whole chunk from now on
+  if ((int)m_edits.size() > DebugSettings::instance.maxChunkEditLogSize) {
+    m_compacted = true;
+    m_edits = {};
+  }
+}
+
+bool Chunk::LoadCache(const std::vector<unsigned char>& payload) {
+  // [version][blocks size][blocks][lights]
+  if (payload.size() < 5 || payload[0] != TERRAIN_CACHE_VERSION) return false;
+
+  size_t blocksSize = payload[1] | (payload[2] << 8) | (payload[3] << 16) | ((size_t)payload[4] << 24);
+  const unsigned char* blocks = payload.data() + 5;
+  if (blocksSize > payload.size() - 5) return false;
+  const unsigned char* lights = blocks + blocksSize;
+  size_t lightsSize = payload.size() - 5 - blocksSize;
+
+  if (!Compression::RunLengthDecode(blocks, blocksSize, m_blockstates.get(), CHUNK_VOLUME)) return false;
+  if (!Compression::RunLengthDecode(lights, lightsSize, reinterpret_cast<unsigned char*>(m_lights.get()), CHUNK_VOLUME)) return false;
+
+  m_loadedFromCache = true;
+
+  // Cached chunks are finished, only the neighbors need this chunk's structures
+  GenerateHeightmap();
+  PlaceStructures(/*writeInside=*/false);
 
   {
     std::lock_guard<std::mutex> lock(m_stateMutex);
     m_state = GENERATED_TERRAIN;
   }
+  return true;
+}
+
+std::vector<unsigned char> Chunk::SerializeCache() const {
+  std::vector<unsigned char> payload = { TERRAIN_CACHE_VERSION, 0, 0, 0, 0 };
+  Compression::RunLengthEncode(m_blockstates.get(), CHUNK_VOLUME, payload);
+
+  uint32_t blocksSize = (uint32_t)(payload.size() - 5);
+  for (int i = 0; i < 4; i++) {
+    payload[1 + i] = (blocksSize >> (i * 8)) & 0xFF;
+  }
+
+  Compression::RunLengthEncode(reinterpret_cast<const unsigned char*>(m_lights.get()), CHUNK_VOLUME, payload);
+  return payload;
 }
 
-void Chunk::GenerateMeshForSubchunk(int i) {
-  // Need to generate a list of vertices and indices
+bool Chunk::IsCacheable() const {
+  // Lights are only final once all the neighbors have been lit, which is guaranteed after meshing
+  return !a_modified && !m_compacted && m_edits.empty() && !m_loadedFromCache && GetState() >= GENERATED_MESH;
+}
 
-  std::vector<float>& vertices = m_subchunkMeshesData[i].vertices;
-  std::vector<unsigned int>& indices = m_subchunkMeshesData[i].indices;
+void Chunk::RecalculateLights() {
+  for (int i = 0; i < CHUNK_VOLUME; i++) {
+    m_lights[i].m_value = 0;
+    m_lights[i].SetLight(LightType::BLOCK, Block::FromBlockstate(m_blockstates[i]).GetLightLevel());
+  }
 
-  int vertexCount = 0;
+  FillSkyLight();
+}
+
+void Chunk::GenerateMeshForSubchunk(int i, bool trackVoxels) {
+  // Need to generate a list of vertices and indices for each render layer
+  SubchunkMeshData& data = m_subchunkMeshesData[i];
 
   int y0 = i * SUBCHUNK_HEIGHT;
 
-  vertices.clear();
-  indices.clear();
+  for (MeshData& layer : data.layers) {
+    layer.vertices.clear();
+    layer.indices.clear();
+    layer.unusedQuads = 0;
+  }
+  if (trackVoxels) {
+    data.voxelQuads.assign(CHUNK_WIDTH * SUBCHUNK_HEIGHT * CHUNK_WIDTH, 0);
+  } else {
+    std::vector<uint32_t>().swap(data.voxelQuads);
+  }
+
+  // Each blockstate's block is only looked up once
+  enum : unsigned char { FILLED = 1, SOLID = 2, UNKNOWN = 0xFF };
+  std::array<unsigned char, 256> blockstateFlags;
+  blockstateFlags.fill(UNKNOWN);
+
+  // Which cells have a block and which hide the faces against them
+  uint32_t filled[MESH_COLUMNS * MESH_COLUMNS] = {};
+  uint32_t solid[MESH_COLUMNS * MESH_COLUMNS] = {};
+  for (int x = -1; x <= CHUNK_WIDTH; x++) {
+    for (int z = -1; z <= CHUNK_WIDTH; z++) {
+      bool outsideX = x < 0 || x >= CHUNK_WIDTH;
+      bool outsideZ = z < 0 || z >= CHUNK_WIDTH;
+      // Corners are never next to a face
+      if (outsideX && outsideZ) continue;
+
+      Chunk* chunk = this;
+      glm::ivec3 local = { x, 0, z };
+      std::shared_ptr<Chunk> neighbor;
+      if (outsideX || outsideZ) {
+        neighbor = GetNeighbor(x, z);
+        if (neighbor == nullptr) continue;
+        chunk = neighbor.get();
+        local = ToNeighborCoords(x, 0, z);
+      }
+
+      int column = (x + 1) * MESH_COLUMNS + z + 1;
+      for (int k = 0; k < SUBCHUNK_HEIGHT + 2; k++) {
+        int y = y0 - 1 + k;
+        if (y < 0 || y >= CHUNK_HEIGHT) continue;
 
+        Blockstate blockstate = chunk->m_blockstates[PosToIndex(local.x, y, local.z)];
+        unsigned char& flags = blockstateFlags[blockstate];
+        if (flags == UNKNOWN) {
+          const Block& block = Block::FromBlockstate(blockstate);
+          flags = (block.IsAir() ? 0 : FILLED) | (block.IsSolid() ? SOLID : 0);
+        }
+
+        if (flags & FILLED) filled[column] |= 1u << k;
+        if (flags & SOLID) solid[column] |= 1u << k;
+      }
+    }
+  }
+
+  // Kept per thread so its buffers are reused, it is only built for subchunks with faces
+  thread_local CornerLightCache lights;
+  bool lightsBuilt = false;
+
+  const std::vector<Direction>& directions = DirectionUtil::GetAllDirections();
+  int quadCounts[RENDER_LAYER_COUNT] = {};
   for (int x = 0; x < CHUNK_WIDTH; x++) {
-    for (int y = 0; y < SUBCHUNK_HEIGHT; y++) {
-      for (int z = 0; z < CHUNK_WIDTH; z++) {
-        const Block& block = Block::FromBlockstate(m_blockstates[PosToIndex(x, y + y0, z)]);
-
-        // Skip air blocks
-        if (block.IsAir()) continue;
-
-        for (const auto& face : DirectionUtil::GetAllDirections()) {
-          glm::ivec3 offset = VoxelData::GetFaceOffset(face);
-          // Skip face if there is a neighbor in that direction
-          const Block& neighborBlock = GetBlockAt(x + offset.x, y + offset.y + y0, z + offset.z);
-          if (neighborBlock.IsSolid() || (block.ShouldHideNeighbors() && block == neighborBlock)) continue;
-
-          std::vector<float> faceVertices = VoxelData::GetFaceVertices(x, y + y0, z, *this, face, block);
-          vertices.insert(vertices.end(), faceVertices.begin(), faceVertices.end());
-
-          // Indices: 0, 1, 2, 2, 3, 0
-          indices.push_back(vertexCount + 0);
-          indices.push_back(vertexCount + 1);
-          indices.push_back(vertexCount + 2);
-          indices.push_back(vertexCount + 2);
-          indices.push_back(vertexCount + 3);
-          indices.push_back(vertexCount + 0);
-          vertexCount += 4;
+    for (int z = 0; z < CHUNK_WIDTH; z++) {
+      int column = (x + 1) * MESH_COLUMNS + z + 1;
+
+      // A face shows where the cell has a block and the one next to it doesn't hide it
+      uint32_t faceMasks[6];
+      uint32_t anyFaces = 0;
+      for (int f = 0; f < 6; f++) {
+        glm::ivec3 offset = VoxelData::GetFaceOffset(directions[f]);
+        uint32_t neighborSolid = solid[column + offset.x * MESH_COLUMNS + offset.z];
+        // Line the cells above or below up with the cells they cover
+        if (offset.y > 0) neighborSolid >>= 1;
+        if (offset.y < 0) neighborSolid <<= 1;
+
+        faceMasks[f] = filled[column] & ~neighborSolid & MESH_COLUMN_INNER_BITS;
+        anyFaces |= faceMasks[f];
+      }
+
+      if (anyFaces != 0 && !lightsBuilt) {
+        lights.Build(*this, { 0, y0, 0 }, { CHUNK_WIDTH, SUBCHUNK_HEIGHT, CHUNK_WIDTH });
+        lightsBuilt = true;
+      }
+
+      while (anyFaces != 0) {
+        int k = MathUtil::LowestSetBit(anyFaces);
+        anyFaces &= anyFaces - 1;
+
+        int y = y0 + k - 1;
+        const Block& block = Block::FromBlockstate(m_blockstates[PosToIndex(x, y, z)]);
+        int layer = (int)block.GetRenderLayer();
+        std::vector<float>& vertices = data.layers[layer].vertices;
+        int& quadCount = quadCounts[layer];
+        int first = quadCount;
+
+        for (int f = 0; f < 6; f++) {
+          if ((faceMasks[f] & (1u << k)) == 0) continue;
+
+          if (block.ShouldHideNeighbors()) {
+            glm::ivec3 offset = VoxelData::GetFaceOffset(directions[f]);
+            if (block == GetBlockAt(x + offset.x, y + offset.y, z + offset.z)) continue;
+          }
+
+          VoxelData::AddFaceVertices(x, y, z, lights, directions[f], block, vertices);
+          quadCount++;
         }
 
+        if (trackVoxels) {
+          data.voxelQuads[(x * SUBCHUNK_HEIGHT + k - 1) * CHUNK_WIDTH + z] = (first << 8) | (layer << 4) | (quadCount - first);
+        }
       }
     }
   }
+  bool hasFaces = false;
+  for (int layer = 0; layer < RENDER_LAYER_COUNT; layer++) {
+    AppendQuadIndices(data.layers[layer].indices, 0, quadCounts[layer]);
+    hasFaces |= quadCounts[layer] > 0;
+  }
+
+  std::vector<unsigned char>& lightVolume = data.lightVolume;
+  if (DebugSettings::instance.useLightVolumes && hasFaces) {
+    BuildLightVolume(i, lightVolume);
+  } else {
+    lightVolume.clear();
+  }
+}
+
+int Chunk::AddVoxelFaces(int x, int y, int z, const CornerLightCache& lights, std::vector<float>& vertices) {
+  const Block& block = Block::FromBlockstate(m_blockstates[PosToIndex(x, y, z)]);
+
+  // Skip air blocks
+  if (block.IsAir()) return 0;
+
+  int count = 0;
+  for (const auto& face : DirectionUtil::GetAllDirections()) {
+    glm::ivec3 offset = VoxelData::GetFaceOffset(face);
+    // Skip face if there is a neighbor in that direction
+    const Block& neighborBlock = GetBlockAt(x + offset.x, y + offset.y, z + offset.z);
+    if (neighborBlock.IsSolid() || (block.ShouldHideNeighbors() && block == neighborBlock)) continue;
+
+    VoxelData::AddFaceVertices(x, y, z, lights, face, block, vertices);
+    count++;
+  }
+  return count;
+}
+
+bool Chunk::PatchSubchunk(int i) {
+  SubchunkMeshData& data = m_subchunkMeshesData[i];
+  // The first edit remeshes the subchunk to learn where each voxel's quads are
+  if (data.voxelQuads.empty() || m_subchunkMeshes.empty()) return false;
+  if (DebugSettings::instance.useLightVolumes && m_lightVolumes[i] == nullptr) return false;
+
+  int y0 = i * SUBCHUNK_HEIGHT;
+  int oldQuadCounts[RENDER_LAYER_COUNT];
+  int firstChanged[RENDER_LAYER_COUNT];
+  int endChanged[RENDER_LAYER_COUNT];
+  for (int layer = 0; layer < RENDER_LAYER_COUNT; layer++) {
+    oldQuadCounts[layer] = firstChanged[layer] = data.layers[layer].vertices.size() / FLOATS_PER_QUAD;
+    endChanged[layer] = 0;
+  }
+  std::vector<float> faces;
+
+  auto markChanged = [&](int layer, int first, int count) {
+    if (count == 0) return;
+    firstChanged[layer] = std::min(firstChanged[layer], first);
+    endChanged[layer] = std::max(endChanged[layer], first + count);
+  };
+  // Degenerate quads (all vertices at the origin) fill the slots nothing uses anymore
+  auto clearQuads = [&](int layer, int first, int count) {
+    if (count == 0) return;
+    std::vector<float>& vertices = data.layers[layer].vertices;
+    std::fill(vertices.begin() + first * FLOATS_PER_QUAD, vertices.begin() + (first + count) * FLOATS_PER_QUAD, 0.0f);
+    data.layers[layer].unusedQuads += count;
+    markChanged(layer, first, count);
+  };
+
+  CornerLightCache lights;
+  for (const glm::ivec3& position : m_patchPositions) {
+    // The blocks around the position that are in this subchunk
+    glm::ivec3 min = glm::max(position - 1, glm::ivec3 { 0, y0, 0 });
+    glm::ivec3 max = glm::min(position + 1, glm::ivec3 { CHUNK_WIDTH - 1, y0 + SUBCHUNK_HEIGHT - 1, CHUNK_WIDTH - 1 });
+    if (glm::any(glm::greaterThan(min, max))) continue;
+    lights.Build(*this, min, max - min + 1);
+
+    for (int x = min.x; x <= max.x; x++) {
+      for (int y = min.y; y <= max.y; y++) {
+        for (int z = min.z; z <= max.z; z++) {
+          uint32_t& run = data.voxelQuads[(x * SUBCHUNK_HEIGHT + y - y0) * CHUNK_WIDTH + z];
+          int first = run >> 8;
+          int oldLayer = (run >> 4) & 0xF;
+          int count = run & 0xF;
+
+          faces.clear();
+          int newCount = AddVoxelFaces(x, y, z, lights, faces);
+          int layer = (int)Block::FromBlockstate(m_blockstates[PosToIndex(x, y, z)]).GetRenderLayer();
+
+          if (count == 0 && newCount == 0) continue;
+
+          // A block of another layer leaves its old quads behind
+          if (layer != oldLayer) {
+            clearQuads(oldLayer, first, count);
+            count = 0;
+          }
+
+          MeshData& mesh = data.layers[layer];
+          if (newCount > count) {
+            clearQuads(layer, first, count);
+
+            first = mesh.vertices.size() / FLOATS_PER_QUAD;
+            mesh.vertices.resize(mesh.vertices.size() + newCount * FLOATS_PER_QUAD);
+            AppendQuadIndices(mesh.indices, first, newCount);
+            count = newCount;
+          } else {
+            clearQuads(layer, first + newCount, count - newCount);
+          }
+
+          std::copy(faces.begin(), faces.end(), mesh.vertices.begin() + first * FLOATS_PER_QUAD);
+          markChanged(layer, first, newCount);
+          run = (first << 8) | (layer << 4) | newCount;
+        }
+      }
+    }
+  }
+
+  for (int layer = 0; layer < RENDER_LAYER_COUNT; layer++) {
+    const MeshData& mesh = data.layers[layer];
+    if (mesh.unusedQuads * 2 > (int)mesh.vertices.size() / FLOATS_PER_QUAD) return false;
+  }
+
+  for (int layer = 0; layer < RENDER_LAYER_COUNT; layer++) {
+    if (firstChanged[layer] >= endChanged[layer]) continue;
+
+    MeshData& mesh = data.layers[layer];
+    int quadCount = mesh.vertices.size() / FLOATS_PER_QUAD;
+    // Indices only change where quads were appended, unless the quads are sorted and all of them are sent again
+    int firstNewIndexQuad = std::min(std::max(firstChanged[layer], oldQuadCounts[layer]), quadCount);
+    if (layer == (int)RenderLayer::TRANSLUCENT) firstNewIndexQuad = quadCount;
+
+    std::unique_ptr<MeshBuffers>& buffers = m_subchunkMeshes[i * RENDER_LAYER_COUNT + layer];
+    bool patched = buffers != nullptr && buffers->PatchData(
+      mesh.vertices.data() + firstChanged[layer] * FLOATS_PER_QUAD, firstChanged[layer] * FLOATS_PER_QUAD,
+      (endChanged[layer] - firstChanged[layer]) * FLOATS_PER_QUAD,
+      mesh.indices.data() + firstNewIndexQuad * INDICES_PER_QUAD, firstNewIndexQuad * INDICES_PER_QUAD,
+      (quadCount - firstNewIndexQuad) * INDICES_PER_QUAD, mesh.indices.size());
+
+    // Out of room, the buffers grow with spare room again
+    if (!patched) UploadLayer(i, (RenderLayer)layer, /*spareRoom=*/true);
+    if (layer == (int)RenderLayer::TRANSLUCENT) {
+      m_translucentSubchunks |= 1u << i;
+      glm::ivec3 origin = ToGlobalCoords(0, 0, 0);
+      SortTranslucentQuads(i, m_world.GetTranslucentSortEye() - glm::vec3(origin));
+    }
+  }
+  return true;
+}
+
+void Chunk::UploadLayer(int i, RenderLayer layer, bool spareRoom) {
+  MeshData& data = m_subchunkMeshesData[i].layers[(int)layer];
+  std::unique_ptr<MeshBuffers>& mesh = m_subchunkMeshes[i * RENDER_LAYER_COUNT + (int)layer];
+
+  if (layer == RenderLayer::TRANSLUCENT) {
+    if (data.vertices.empty()) {
+      m_translucentSubchunks &= ~(1u << i);
+    } else {
+      m_translucentSubchunks |= 1u << i;
+    }
+  }
+
+  // Most subchunks never have faces in some layers, those don't need buffers
+  if (mesh == nullptr) {
+    RenderBackend* backend = m_world.GetRenderBackend();
+    if (data.vertices.empty() || backend == nullptr) return;
+    mesh = backend->CreateMeshBuffers();
+  }
+
+  if (spareRoom) {
+    mesh->SetData(data, WithSpareRoom(data.vertices.size(), FLOATS_PER_QUAD), WithSpareRoom(data.indices.size(), INDICES_PER_QUAD));
+  } else {
+    mesh->SetData(data);
+  }
+}
+
+void Chunk::SortTranslucentQuads(glm::vec3 eye) {
+  if (m_translucentSubchunks == 0) return;
+
+  glm::vec3 localEye = eye - glm::vec3(ToGlobalCoords(0, 0, 0));
+  for (int i = 0; i < SUBCHUNK_LAYERS; i++) {
+    if (m_translucentSubchunks & (1u << i)) SortTranslucentQuads(i, localEye);
+  }
+}
+
+void Chunk::SortTranslucentQuads(int i, glm::vec3 localEye) {
+  MeshData& data = m_subchunkMeshesData[i].layers[(int)RenderLayer::TRANSLUCENT];
+  MeshBuffers* mesh = m_subchunkMeshes[i * RENDER_LAYER_COUNT + (int)RenderLayer::TRANSLUCENT].get();
+  if (mesh == nullptr) return;
+
+  // Only the indices move, so the voxels keep pointing at their quads
+  int quadCount = data.vertices.size() / FLOATS_PER_QUAD;
+  std::vector<std::pair<float, int>> distances(quadCount);
+  for (int quad = 0; quad < quadCount; quad++) {
+    // Opposite corners of a quad share its center
+    const float* first = &data.vertices[quad * FLOATS_PER_QUAD];
+    const float* third = first + FLOATS_PER_QUAD / 2;
+    glm::vec3 center = glm::vec3(first[0] + third[0], first[1] + third[1], first[2] + third[2]) * 0.5f;
+    glm::vec3 diff = center - localEye;
+    distances[quad] = { -glm::dot(diff, diff), quad };
+  }
+  std::sort(distances.begin(), distances.end());
+
+  data.indices.clear();
+  for (const auto& [_, quad] : distances) {
+    AppendQuadIndices(data.indices, quad, 1);
+  }
+  mesh->PatchData(nullptr, 0, 0, data.indices.data(), 0, data.indices.size(), data.indices.size());
+}
+
+void Chunk::BuildLightVolume(int i, std::vector<unsigned char>& volume) {
+  int y0 = i * SUBCHUNK_HEIGHT;
+  volume.resize(LIGHT_VOLUME_SIZE * LIGHT_VOLUME_SIZE * LIGHT_VOLUME_SIZE * 4);
+
+  // Laid out x first, then y, then z, with the cells at -1 holding the neighbors'
+  unsigned char* texel = volume.data();
+  for (int z = -1; z < CHUNK_WIDTH + 1; z++) {
+    for (int y = y0 - 1; y < y0 + SUBCHUNK_HEIGHT + 1; y++) {
+      for (int x = -1; x < CHUNK_WIDTH + 1; x++, texel += 4) {
+        bool open;
+        char skyLight;
+        char blockLight;
+        if (y >= CHUNK_HEIGHT) {
+          open = true;
+          skyLight = 15;
+          blockLight = 0;
+        } else {
+          open = y >= 0 && !GetBlockAt(x, y, z).IsSolid();
+          skyLight = open ? GetLightAt(LightType::SKY, x, y, z) : 0;
+          blockLight = open ? GetLightAt(LightType::BLOCK, x, y, z) : 0;
+        }
 
+        texel[0] = skyLight * 17;
+        texel[1] = blockLight * 17;
+        texel[2] = open ? 255 : 0;
+        texel[3] = 255;
+      }
+    }
+  }
 }
 
-void Chunk::MarkPositionDirty(glm::ivec3 localPosition) {
-  if (IsInOtherChunk(localPosition.x, localPosition.y, localPosition.z)) {
-    m_world.MarkPositionDirty(ToGlobalCoords(localPosition));
-  } else if (localPosition.y >= 0 && localPosition.y < CHUNK_HEIGHT) {
-    int index = GetSubchunkIndex(localPosition.y);
-    m_dirtySubchunks.insert(index);
-    m_world.MarkChunkDirty(this);
+void Chunk::ApplyLightVolume(int i) {
+  std::vector<unsigned char>& volume = m_subchunkMeshesData[i].lightVolume;
+  if (volume.empty()) {
+    m_lightVolumes[i].reset();
+    return;
+  }
+
+  if (m_lightVolumes[i] == nullptr) {
+    RenderBackend* backend = m_world.GetRenderBackend();
+    if (backend != nullptr) m_lightVolumes[i] = backend->CreateLightVolume();
   }
+  if (m_lightVolumes[i] != nullptr) m_lightVolumes[i]->SetData(LIGHT_VOLUME_SIZE, volume.data());
+
+  // The buffer keeps its own copy
+  std::vector<unsigned char>().swap(volume);
+}
+
+void Chunk::MarkPositionDirty(glm::ivec3 localPosition, bool lightOnly) {
+  MarkRegionDirty(localPosition, localPosition, lightOnly);
 }
 
 void Chunk::MarkPositionAndNeighborsDirty(glm::ivec3 localPosition) {
@@ -464,47 +1278,102 @@ void Chunk::MarkPositionAndNeighborsDirty(glm::ivec3 localPosition) {
   }
 }
 
-void Chunk::MarkPositionAndAllNeighborsDirty(glm::ivec3 localPosition) {
-  for (int x = -1; x <= 1; x++) {
-    for (int y = -1; y <= 1; y++) {
-      for (int z = -1; z <= 1; z++) {
-        MarkPositionDirty(localPosition + glm::ivec3 { x, y, z });
+void Chunk::MarkPositionAndAllNeighborsDirty(glm::ivec3 localPosition, bool lightOnly) {
+  MarkRegionDirty(localPosition - 1, localPosition + 1, lightOnly);
+}
+
+template <typename F>
+void Chunk::ForEachChunkInRegion(glm::ivec3 min, glm::ivec3 max, F f) {
+  min.y = std::max(min.y, 0);
+  max.y = std::min(max.y, CHUNK_HEIGHT - 1);
+  if (min.y > max.y) return;
+
+  // The same layers are crossed in every chunk the box reaches into
+  uint16_t layers = ((2u << GetSubchunkIndex(max.y)) - 1) & ~((1u << GetSubchunkIndex(min.y)) - 1);
+
+  for (int dx = -1; dx <= 1; dx++) {
+    if (max.x < dx * CHUNK_WIDTH || min.x >= (dx + 1) * CHUNK_WIDTH) continue;
+    for (int dz = -1; dz <= 1; dz++) {
+      if (max.z < dz * CHUNK_WIDTH || min.z >= (dz + 1) * CHUNK_WIDTH) continue;
+
+      if (dx == 0 && dz == 0) {
+        f(*this, glm::ivec3 { 0, 0, 0 }, layers);
+      } else if (std::shared_ptr<Chunk> neighbor = GetNeighbor(dx * CHUNK_WIDTH, dz * CHUNK_WIDTH)) {
+        f(*neighbor, glm::ivec3 { dx * CHUNK_WIDTH, 0, dz * CHUNK_WIDTH }, layers);
       }
     }
   }
 }
 
-void Chunk::CleanDirty() {
-  for (int i : m_dirtySubchunks) {
-    GenerateMeshForSubchunk(i);
+void Chunk::MarkRegionDirty(glm::ivec3 min, glm::ivec3 max, bool lightOnly) {
+  ForEachChunkInRegion(min, max, [&](Chunk& chunk, glm::ivec3 origin, uint16_t layers) {
+    (lightOnly ? chunk.m_dirtyLightVolumes : chunk.m_dirtySubchunks) |= layers;
+    m_world.MarkChunkDirty(&chunk);
+  });
+}
 
-    std::vector<float>& vertices = m_subchunkMeshesData[i].vertices;
-    std::vector<unsigned int>& indices = m_subchunkMeshesData[i].indices;
+void Chunk::MarkEditDirty(glm::ivec3 localPosition) {
+  ForEachChunkInRegion(localPosition - 1, localPosition + 1, [&](Chunk& chunk, glm::ivec3 origin, uint16_t layers) {
+    chunk.m_patchSubchunks |= layers;
+    chunk.m_patchPositions.push_back(localPosition - origin);
+    m_world.MarkChunkDirty(&chunk);
+  });
+}
 
-    m_subchunkMeshes[i].SetData(vertices.data(), vertices.size(), indices.data(), indices.size());
+void Chunk::MarkLightDirty(glm::ivec3 localPosition) {
+  if (m_hasLightDirty) {
+    m_lightDirtyMin = glm::min(m_lightDirtyMin, localPosition);
+    m_lightDirtyMax = glm::max(m_lightDirtyMax, localPosition);
+  } else {
+    m_lightDirtyMin = m_lightDirtyMax = localPosition;
+    m_hasLightDirty = true;
   }
-  m_dirtySubchunks.clear();
 }
 
-void Chunk::Draw(Shader& shader) const {
-  // TODO: Use some sort of frustum culling to prevent non-visible chunks from being drawn
-  if (!m_active || m_state < APPLIED_MESH) return;
+void Chunk::FlushLightDirty() {
+  if (!m_hasLightDirty) return;
+  m_hasLightDirty = false;
+
+  // A volume has a border of one cell, so the same neighbors hold the positions as with baked lights
+  MarkRegionDirty(m_lightDirtyMin - 1, m_lightDirtyMax + 1, /*lightOnly=*/DebugSettings::instance.useLightVolumes);
+}
 
-  glm::mat4 model(1.0f);
-  const DebugSettings& settings = DebugSettings::instance;
+void Chunk::CleanDirty() {
+  if (m_subchunkMeshes.empty()) m_subchunkMeshes.resize(SUBCHUNK_LAYERS * RENDER_LAYER_COUNT);
+  if (m_lightVolumes.empty()) m_lightVolumes.resize(SUBCHUNK_LAYERS);
 
-  model = glm::translate(model, { m_chunkCoord.x * CHUNK_WIDTH, 0, m_chunkCoord.y * CHUNK_WIDTH });
   for (int i = 0; i < SUBCHUNK_LAYERS; i++) {
-    if (m_subchunkMeshes[i].HasData()) {
-      shader.LoadMatrix4f("model", model);
-      m_subchunkMeshes[i].Draw();
-    } else {
-      LOG(WARN) << "Tried to draw subchunk at (" << m_chunkCoord.x << ", " << i << ", " << m_chunkCoord.y << ") before generating mesh";
+    if ((m_patchSubchunks & ~m_dirtySubchunks & (1u << i)) == 0) continue;
+    if (!PatchSubchunk(i)) m_dirtySubchunks |= 1u << i;
+  }
+  m_patchSubchunks = 0;
+  m_patchPositions.clear();
+
+  glm::vec3 localEye = m_world.GetTranslucentSortEye() - glm::vec3(ToGlobalCoords(0, 0, 0));
+  for (int i = 0; i < SUBCHUNK_LAYERS; i++) {
+    if ((m_dirtySubchunks & (1u << i)) == 0) continue;
+
+    // Edits tend to come in bursts, so the next ones in this subchunk are patched into spare room in the buffers
+    GenerateMeshForSubchunk(i, /*trackVoxels=*/true);
+
+    for (int layer = 0; layer < RENDER_LAYER_COUNT; layer++) {
+      UploadLayer(i, (RenderLayer)layer, /*spareRoom=*/true);
     }
+    if (m_translucentSubchunks & (1u << i)) SortTranslucentQuads(i, localEye);
+    ApplyLightVolume(i);
+  }
+  // Remeshed subchunks built their volumes already
+  m_dirtyLightVolumes &= ~m_dirtySubchunks;
+  m_dirtySubchunks = 0;
+
+  // Subchunks drawn with baked lights get new lights with their next mesh
+  for (int i = 0; i < SUBCHUNK_LAYERS; i++) {
+    if ((m_dirtyLightVolumes & (1u << i)) == 0 || m_lightVolumes[i] == nullptr) continue;
 
-    // Translate the model upwards
-    model = glm::translate(model, { 0, SUBCHUNK_HEIGHT, 0 });
+    BuildLightVolume(i, m_subchunkMeshesData[i].lightVolume);
+    ApplyLightVolume(i);
   }
+  m_dirtyLightVolumes = 0;
 }
 
 Blockstate Chunk::GetBlockstateAt(int localX, int localY, int localZ) {
@@ -537,19 +1406,6 @@ char Chunk::GetLightAt(LightType type, int localX, int localY, int localZ) {
   return 0;
 }
 
-float Chunk::GetFixedLightAt(LightType type, int localX, int localY, int localZ) {
-  if (localY < 0 || localY >= CHUNK_HEIGHT) return 0;
-  const Block& block = Block::FromBlockstate(GetBlockstateAt(localX, localY, localZ));
-  char lightLevel;
-  if (block.IsSolid()) {
-    lightLevel = -1;
-  } else {
-    lightLevel = GetLightAt(type, localX, localY, localZ);
-  }
-  float light = lightLevel / 15.0f;
-  return light;
-}
-
 void Chunk::SetLightAt(LightType type, int localX, int localY, int localZ, char value) {
   if (IsInsideChunk(localX, localY, localZ)) {
     m_lights[PosToIndex(localX, localY, localZ)].SetLight(type, value);
@@ -578,6 +1434,19 @@ void Chunk::SetActive(bool value) {
   m_active = value;
 }
 
+bool Chunk::IsDrawable() const {
+  // Only the render thread moves the chunk in and out of APPLIED_MESH
+  return m_active && m_state >= APPLIED_MESH;
+}
+
+const MeshBuffers* Chunk::GetMeshBuffers(int subchunk, RenderLayer layer) const {
+  return m_subchunkMeshes[subchunk * RENDER_LAYER_COUNT + (int)layer].get();
+}
+
+const LightVolumeBuffer* Chunk::GetLightVolume(int subchunk) const {
+  return m_lightVolumes[subchunk].get();
+}
+
 void Chunk::InvalidateMesh() {
   std::lock_guard<std::mutex> lock(m_stateMutex);
   m_state = PROPAGATED_LIGHTING;
@@ -592,15 +1461,6 @@ glm::ivec2 Chunk::GetChunkCoord() const {
   return m_chunkCoord;
 }
 
-inline int Chunk::PosToIndex(int localX, int localY, int localZ) const {
-  // x  y  z
-  return localZ + localY * CHUNK_WIDTH + localX * CHUNK_HEIGHT * CHUNK_WIDTH;
-}
-
-inline int Chunk::PosToIndex(const glm::ivec3& local) const {
-  return local.z + local.y * CHUNK_WIDTH + local.x * CHUNK_HEIGHT * CHUNK_WIDTH;
-}
-
 bool Chunk::IsInsideChunk(int localX, int localY, int localZ) const {
   return localX >= 0 && localY >= 0 && localZ >= 0 && localX < CHUNK_WIDTH && localY < CHUNK_HEIGHT && localZ < CHUNK_WIDTH;
 }
@@ -638,39 +1498,6 @@ glm::ivec3 Chunk::ToNeighborCoords(int localX, int localY, int localZ) const {
   };
 }
 
-void Chunk::SpawnTrees() {
-  for (const auto& pos : m_treeLocations) {
-    int x = pos.x;
-    int y = pos.y;
-    int z = pos.z;
-
-    int treeHeight = MathUtil::IntLerp(5, 9, Noise::RandomNoise2D(x, z, 1000, 1000));
-
-    SetBlockstateAt(x, y - 1, z, Blocks::DIRT);
-    for (int i = 0; i < treeHeight; i++) {
-      SetBlockstateAt(x, y + i, z, Blocks::OAK_LOG);
-    }
-
-    for (int dx = -2; dx <= 2; dx++) {
-      for (int dy = -2; dy <= 2; dy++) {
-        for (int dz = -2; dz <= 2; dz++) {
-          if (dx == 0 && dz == 0 && dy < 0) continue;
-          if (IsInOtherChunk(x + dx, y + dy + treeHeight, z + dz)) continue;
-          SetBlockstateAt(x + dx, y + dy + treeHeight, z + dz, Blocks::OAK_LEAVES);
-        }
-      }
-    }
-  }
-}
-
-char SkyBlockLight::GetLight(LightType type) {
-  if (type == LightType::SKY) {
-    return m_value & (unsigned char)0b00001111;
-  } else {
-    return m_value >> 4;
-  }
-}
-
 void SkyBlockLight::SetLight(LightType type, char value) {
   DEBUG_ASSERT(value >= 0 && value <= 15) << "Light level invalid";
 
@@ -2,21 +2,30 @@
 
 #include <glm/vec2.hpp>
 #include <vector>
+#include <array>
 #include <optional>
-#include <unordered_set>
 #include <atomic>
+#include <mutex>
+#include <memory>
+#include <cstdint>
 #include "util/ClassMacros.h"
-#include "rendering/meshes/Mesh.h"
-#include "rendering/Shader.h"
 #include <shared_mutex>
 #include "../init/Blocks.h"
 #include "util/GlmExtensions.h"
+#include "generation/GenerationStage.h"
+#include "RenderBackend.h"
 
 class World;
+class CornerLightCache;
 
-struct MeshData {
-  std::vector<float> vertices;
-  std::vector<unsigned int> indices;
+struct SubchunkMeshData {
+  // One mesh per render layer
+  std::array<MeshData, RENDER_LAYER_COUNT> layers;
+  // Only filled with light volumes, and released once uploaded
+  std::vector<unsigned char> lightVolume;
+  // First quad of each voxel in its layer's mesh, shifted left by 8, its layer, shifted left by 4, and its quad count.
+  // Only kept for subchunks remeshed after an edit, so the next edits patch the quads around them in place
+  std::vector<uint32_t> voxelQuads;
 };
 
 // TODO: Abstract lighting to a separate file
@@ -30,12 +39,26 @@ struct SkyBlockLight {
   // first 4 bits are sky, last 4 bits are block
   unsigned char m_value = 0;
 
-  char GetLight(LightType type);
+  // Inline since the mesher reads every light around a subchunk
+  char GetLight(LightType type) const {
+    if (type == LightType::SKY) {
+      return m_value & (unsigned char)0b00001111;
+    } else {
+      return m_value >> 4;
+    }
+  }
   void SetLight(LightType type, char value);
 };
 
+struct BlockEdit {
+  uint16_t index;
+  Blockstate blockstate;
+};
+
 enum ChunkState {
   INITIALIZED,
+  // The chunk's own generation stages ran, but its neighbors' structures may still reach into it
+  GENERATED_STRUCTURES,
   GENERATED_TERRAIN,
   PROPAGATED_LIGHTING,
   GENERATED_MESH,
@@ -48,33 +71,82 @@ class Chunk : public std::enable_shared_from_this<Chunk> {
 public:
   DELETE_COPY(Chunk);
 
+  // The light locks of a group of chunks, which are kept alive until the locks are released
+  struct LightLock {
+    std::vector<std::shared_ptr<Chunk>> chunks;
+    std::vector<std::unique_lock<std::mutex>> locks;
+  };
+
   Chunk(glm::ivec2 chunkCoord, World& world);
 
-  void GenerateTerrain();
+  // Runs the sculpt, paint and structure stages. The terrain is only final after FinishTerrain, which has to wait for
+  // the neighbors' structures. In parallel, the chunk is split into slabs that run on the task pool, which only pays off
+  // when there are few chunks to generate and cores are left idle
+  void GenerateTerrain(bool parallel = false);
+  // Throws away the results of the given stage and the later ones, the next terrain pass reuses the rest.
+  // Only call while no worker is running
+  void ResetGeneration(GenerationStage firstStage);
+  bool IsRegenerating() const;
+  // Runs the stages again after ResetGeneration. Chunks saved as snapshots keep their blocks
+  void RegenerateTerrain(bool parallel = false);
+  // Merges the structures the neighbors placed in this chunk, replays saved edits and sets up the lights.
+  // All 8 neighbors need to be at least GENERATED_STRUCTURES
+  void FinishTerrain();
+  // Blocks this chunk's structures place in the neighbor at the given index, ready once it's GENERATED_STRUCTURES
+  const std::vector<BlockEdit>& GetStructureWrites(int neighborIndex) const;
+  // Restores the terrain from a payload made by Serialize, returns false if the payload can't be read
+  bool LoadTerrain(const std::vector<unsigned char>& payload);
+  // Edited chunks are stored as their edit log over the generated terrain, or as a full snapshot once the log grows too big
+  std::vector<unsigned char> Serialize() const;
+  void RecordEdit(glm::ivec3 localPosition, Blockstate blockstate);
+  // Terrain cache payloads hold the blocks and the final lights of an unedited chunk
+  bool LoadCache(const std::vector<unsigned char>& payload);
+  std::vector<unsigned char> SerializeCache() const;
+  bool IsCacheable() const;
   void GenerateMesh();
   void PropagateLighting();
   void PropagateLightingAtPos(glm::ivec3 localPosition, Blockstate oldBlockstate, Blockstate newBlockstate);
+  // Lights every cell with only open sky above it. Expects the sky light to be cleared
   void FillSkyLight();
+  // Locks the lights of the chunks within the radius, always in the same order so workers lighting nearby chunks
+  // can't deadlock. Light fades within a chunk's width, so spreading light from this chunk needs radius 1
+  LightLock LockLights(int radius);
   void ApplyMesh();
 
   // void UpdateMeshAtPosition(glm::ivec3 position);
 
   // Indicate that the mesh at a certain position is not accurate anymore
-  void MarkPositionDirty(glm::ivec3 localPosition);
+  // Only the light volume needs to be uploaded again for light-only changes
+  void MarkPositionDirty(glm::ivec3 localPosition, bool lightOnly = false);
   void MarkPositionAndNeighborsDirty(glm::ivec3 localPosition);
-  void MarkPositionAndAllNeighborsDirty(glm::ivec3 localPosition);
-  // Recalculate and apply the meshes at dirty subchunks
+  void MarkPositionAndAllNeighborsDirty(glm::ivec3 localPosition, bool lightOnly = false);
+  // Marks every subchunk the box (inclusive, in local coordinates) crosses, here and in the neighbors it reaches into
+  void MarkRegionDirty(glm::ivec3 min, glm::ivec3 max, bool lightOnly = false);
+  // The block at the position changed, only the faces of it and the blocks around it are made again
+  void MarkEditDirty(glm::ivec3 localPosition);
+  // The light at the position changed. With light volumes only the volumes holding it are uploaded again, otherwise
+  // the meshes of every face it lights have to be remade. Only grows a box, see FlushLightDirty
+  void MarkLightDirty(glm::ivec3 localPosition);
+  // Marks the subchunks around the positions given to MarkLightDirty since the last flush
+  void FlushLightDirty();
+  // Recalculate and apply the meshes and light volumes at dirty subchunks
   void CleanDirty();
 
-  void Draw(Shader& shader) const;
+  // Orders the translucent quads of every subchunk back to front as seen from the eye, in global coordinates
+  void SortTranslucentQuads(glm::vec3 eye);
   Blockstate GetBlockstateAt(int localX, int localY, int localZ);
   const Block& GetBlockAt(int localX, int localY, int localZ);
   char GetLightAt(LightType type, int localX, int localY, int localZ);
-  float GetFixedLightAt(LightType type, int localX, int localY, int localZ);
   void SetLightAt(LightType type, int localX, int localY, int localZ, char value);
   void SetBlockstateAt(int localX, int localY, int localZ, Blockstate value);
 
   void SetActive(bool value);
+  // Active with its meshes applied. Render thread only
+  bool IsDrawable() const;
+  // Null for layers without faces, or when the world has no render backend
+  const MeshBuffers* GetMeshBuffers(int subchunk, RenderLayer layer) const;
+  // Null for subchunks drawn with the lights baked into their vertices
+  const LightVolumeBuffer* GetLightVolume(int subchunk) const;
 
   void InvalidateMesh();
 
@@ -88,40 +160,121 @@ public:
   static const int CHUNK_HEIGHT;
   static const int SUBCHUNK_HEIGHT;
   static const int SUBCHUNK_LAYERS;
+  // Number of slabs a chunk generated in parallel is split into along x
+  static const int PARALLEL_GENERATION_SLABS;
 
   bool m_queuedGeneration = false;
 
   std::atomic<bool> a_queuedTerrain = false;
+  std::atomic<bool> a_queuedFinish = false;
   std::atomic<bool> a_queuedMesh = false;
   std::atomic<bool> a_queuedLighting = false;
+  // Set when a block is changed after generation, only modified chunks are saved
+  std::atomic<bool> a_modified = false;
+
+  // Link of the world's list of chunks to clean, only touched by the render thread
+  Chunk* m_nextDirtyChunk = nullptr;
+  bool m_inDirtyList = false;
 
 private:
+  // Reads the blocks and lights of a whole box at once
+  friend class CornerLightCache;
+
   std::vector<std::weak_ptr<Chunk>> m_neighbors;
   glm::ivec2 m_chunkCoord;
 
   std::unique_ptr<Blockstate[]> m_blockstates;
   std::unique_ptr<SkyBlockLight[]> m_lights;
 
-  std::vector<Mesh> m_subchunkMeshes;
-  std::vector<MeshData> m_subchunkMeshesData;
-  std::unordered_set<int> m_dirtySubchunks;
+  // Made by the world's render backend once a mesh is applied, so chunks can be generated and lit without one.
+  // Indexed by subchunk * RENDER_LAYER_COUNT + layer, and only made for layers that had faces at some point
+  std::vector<std::unique_ptr<MeshBuffers>> m_subchunkMeshes;
+  std::vector<SubchunkMeshData> m_subchunkMeshesData;
+  // Subchunks with translucent faces, which are sorted again whenever the eye moves to another block
+  uint16_t m_translucentSubchunks = 0;
+  // One bit per subchunk layer, not per face: a dirty subchunk is always meshed whole, and edits only redo the faces
+  // around the edited blocks anyway (see m_patchSubchunks)
+  uint16_t m_dirtySubchunks = 0;
+  // Lights of each subchunk and the cells around it, sampled by the shader instead of the lights baked in the
+  // vertices. Only made for subchunks meshed while light volumes are enabled
+  std::vector<std::unique_ptr<LightVolumeBuffer>> m_lightVolumes;
+  uint16_t m_dirtyLightVolumes = 0;
+  // Subchunks to patch around the edited positions, unless they are remeshed anyway
+  uint16_t m_patchSubchunks = 0;
+  std::vector<glm::ivec3> m_patchPositions;
+  // Box around the positions whose light changed since the last FlushLightDirty, so a light DFS step only compares
+  // against its corners
+  glm::ivec3 m_lightDirtyMin;
+  glm::ivec3 m_lightDirtyMax;
+  bool m_hasLightDirty = false;
   World& m_world;
 
   // TODO: Make a state enum variable
   mutable std::mutex m_stateMutex;
+  // Held while spreading light, which also writes into the neighbors, see LockLights
+  std::mutex m_lightMutex;
   ChunkState m_state = INITIALIZED;
 
   bool m_active = false;
 
-  void GenerateMeshForSubchunk(int i);
+  // Edits made since generation, replaced by a full snapshot once m_compacted is set
+  std::vector<BlockEdit> m_edits;
+  bool m_compacted = false;
+  // Cached lights are already propagated, only the light leaving the chunk needs to be spread
+  bool m_loadedFromCache = false;
+
+  // Results of the earlier stages, kept so changing a later stage's settings doesn't need them again.
+  // Empty when they have to be generated
+  std::vector<int> m_heightmap;
+  // One bit per block carved by caves
+  std::vector<uint64_t> m_caveMask;
+  bool m_regenerating = false;
+  // Structure blocks that fall in each neighbor, merged by the neighbor when it finishes
+  std::array<std::vector<BlockEdit>, 8> m_structureWrites;
+
+  // Lowest y of each column's open sky, from the last FillSkyLight
+  std::vector<int> m_skyHeights;
+  // Spreads the filled sky light from the cells beside darker columns, the only ones it can leave the sky from
+  void SpreadSkyLight();
+
+  // Generation stages, in order. The later ones only fill the columns with x in [firstX, endX)
+  void GenerateHeightmap();
+  void CarveCaves(int firstX, int endX);
+  void Sculpt(int firstX, int endX);
+  void Paint(int firstX, int endX);
+  // Height of the noise boxes covering the terrain of the columns with x in [firstX, endX)
+  int GetSampleHeight(int firstX, int endX) const;
+  // Loaded chunks already contain their structures, they only compute the writes into their neighbors
+  void PlaceStructures(bool writeInside);
+
+  void GenerateBlocks(bool parallel);
+  void RecalculateLights();
+  // Voxel tracking keeps where each voxel's quads are, so the subchunk can be patched later
+  void GenerateMeshForSubchunk(int i, bool trackVoxels = false);
+  // Appends the visible faces of the block and returns how many there are
+  int AddVoxelFaces(int x, int y, int z, const CornerLightCache& lights, std::vector<float>& vertices);
+  // Makes the faces around the patch positions again and uploads only the changed quads. Returns false if the
+  // subchunk has to be remeshed instead
+  bool PatchSubchunk(int i);
+  // Uploads the layer's mesh data, with spare room for patches if asked to
+  void UploadLayer(int i, RenderLayer layer, bool spareRoom);
+  void SortTranslucentQuads(int i, glm::vec3 localEye);
+  // Calls f(chunk, chunk origin in local coordinates, subchunk layers) for every loaded chunk the box crosses
+  template <typename F>
+  void ForEachChunkInRegion(glm::ivec3 min, glm::ivec3 max, F f);
+  // Sky light, block light and whether each cell is open, with the lights premultiplied so the shader can average
+  // over the open cells only
+  void BuildLightVolume(int i, std::vector<unsigned char>& volume);
+  // Uploads the subchunk's volume, or drops the buffer if it has none
+  void ApplyLightVolume(int i);
 
   void LightSpreadingDFS(LightType type, int x, int y, int z, char value, bool markDirty = false);
   void LightUpdatingDFS(LightType type, int x, int y, int z);
   void LightRemovingDFS(LightType type, int x, int y, int z, char value, char oldValue, PositionsToSpreadLightMap& positionsToSpreadAfter);
   glm::ivec3 ToNeighborCoords(int localX, int localY, int localZ) const;
 
-  std::vector<glm::ivec3> m_treeLocations;
-  void SpawnTrees();
+  bool HasGrassSurface(int localX, int localZ) const;
+  void SetStructureBlock(int localX, int localY, int localZ, Blockstate blockstate, bool writeInside);
 
   inline int PosToIndex(int localX, int localY, int localZ) const;
   inline int PosToIndex(const glm::ivec3& local) const;
@@ -130,4 +283,13 @@ private:
   glm::ivec3 ToGlobalCoords(int localX, int localY, int localZ) const;
   glm::ivec3 ToGlobalCoords(const glm::ivec3& local) const;
   int GetSubchunkIndex(int localY) const;
-};
\ No newline at end of file
+};
+
+inline int Chunk::PosToIndex(int localX, int localY, int localZ) const {
+  // x  y  z
+  return localZ + localY * CHUNK_WIDTH + localX * CHUNK_HEIGHT * CHUNK_WIDTH;
+}
+
+inline int Chunk::PosToIndex(const glm::ivec3& local) const {
+  return local.z + local.y * CHUNK_WIDTH + local.x * CHUNK_HEIGHT * CHUNK_WIDTH;
+}
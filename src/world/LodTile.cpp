@@ -0,0 +1,133 @@
+#include "LodTile.h"
+
+#include <algorithm>
+
+#include "generation/WorldGenerator.h"
+#include "../voxel/Direction.h"
+#include "../init/Blocks.h"
+
+namespace {
+
+const int FLOATS_PER_VERTEX = 7;
+// A top and up to four walls per cell
+const size_t MAX_QUADS = LodTile::CELLS * LodTile::CELLS * 5;
+const size_t QUAD_SIZE = 4 * FLOATS_PER_VERTEX * sizeof(float) + 6 * sizeof(unsigned int);
+
+// Same corner order as the block faces in VoxelData, so the quads face outwards with back-face culling
+void AddQuad(MeshData& mesh, Direction face, float x0, float y0, float z0, float x1, float y1, float z1, const TextureAtlas::TextureCoords& tex) {
+  glm::vec3 corners[4];
+  switch (face) {
+    case Direction::SOUTH: corners[0] = { x0, y1, z1 }; corners[1] = { x0, y0, z1 }; corners[2] = { x1, y0, z1 }; corners[3] = { x1, y1, z1 }; break;
+    case Direction::NORTH: corners[0] = { x1, y1, z0 }; corners[1] = { x1, y0, z0 }; corners[2] = { x0, y0, z0 }; corners[3] = { x0, y1, z0 }; break;
+    case Direction::EAST:  corners[0] = { x1, y1, z1 }; corners[1] = { x1, y0, z1 }; corners[2] = { x1, y0, z0 }; corners[3] = { x1, y1, z0 }; break;
+    case Direction::WEST:  corners[0] = { x0, y1, z0 }; corners[1] = { x0, y0, z0 }; corners[2] = { x0, y0, z1 }; corners[3] = { x0, y1, z1 }; break;
+    case Direction::UP:    corners[0] = { x0, y1, z0 }; corners[1] = { x0, y1, z1 }; corners[2] = { x1, y1, z1 }; corners[3] = { x1, y1, z0 }; break;
+    case Direction::DOWN:  corners[0] = { x1, y0, z0 }; corners[1] = { x1, y0, z1 }; corners[2] = { x0, y0, z1 }; corners[3] = { x0, y0, z0 }; break;
+  }
+  const float texCoords[4][2] = { { tex.x0, tex.y1 }, { tex.x0, tex.y0 }, { tex.x1, tex.y0 }, { tex.x1, tex.y1 } };
+
+  unsigned int first = mesh.vertices.size() / FLOATS_PER_VERTEX;
+  for (int i = 0; i < 4; i++) {
+    // Far terrain is always lit by the sky
+    mesh.vertices.insert(mesh.vertices.end(), { corners[i].x, corners[i].y, corners[i].z, texCoords[i][0], texCoords[i][1], 1.0f, 0.0f });
+  }
+  mesh.indices.insert(mesh.indices.end(), { first, first + 1, first + 2, first + 2, first + 3, first });
+}
+
+} // namespace
+
+LodTile::LodTile(int level, glm::ivec2 tileCoord) :
+  m_level(level), m_tileCoord(tileCoord), m_memoryUsage(0) {}
+
+void LodTile::Generate(const WorldGenerator& generator) {
+  int cellSize = GetSize() * Chunk::CHUNK_WIDTH / CELLS;
+  glm::ivec2 origin = GetFirstChunk() * Chunk::CHUNK_WIDTH;
+
+  // One extra sample around the tile for the walls facing the neighbors
+  const int SAMPLES = CELLS + 2;
+  int heights[SAMPLES * SAMPLES];
+  generator.SampleHeightmap(WorldGenerator::GetThreadContext(), origin.x - cellSize, origin.y - cellSize, SAMPLES, SAMPLES, heights, cellSize);
+  for (int& height : heights) {
+    height = std::clamp(height, 0, Chunk::CHUNK_HEIGHT - 1);
+  }
+
+  // Only the surface block is known, so the whole column looks like it
+  const Block& surface = Blocks::GRASS;
+  const TextureAtlas& atlas = Blocks::GetAtlas();
+  TextureAtlas::TextureCoords topTexture = atlas.GetTextureCoords(surface.GetTextures()[Direction::UP]);
+
+  const Direction WALLS[4] = { Direction::SOUTH, Direction::NORTH, Direction::EAST, Direction::WEST };
+  const glm::ivec2 WALL_OFFSETS[4] = { { 0, 1 }, { 0, -1 }, { 1, 0 }, { -1, 0 } };
+  TextureAtlas::TextureCoords wallTextures[4];
+  for (int i = 0; i < 4; i++) {
+    wallTextures[i] = atlas.GetTextureCoords(surface.GetTextures()[WALLS[i]]);
+  }
+
+  m_meshData.vertices.clear();
+  m_meshData.indices.clear();
+
+  for (int x = 0; x < CELLS; x++) {
+    for (int z = 0; z < CELLS; z++) {
+      float top = heights[(x + 1) * SAMPLES + z + 1] + 1;
+      float x0 = x * cellSize, x1 = x0 + cellSize;
+      float z0 = z * cellSize, z1 = z0 + cellSize;
+
+      AddQuad(m_meshData, Direction::UP, x0, top, z0, x1, top, z1, topTexture);
+
+      for (int i = 0; i < 4; i++) {
+        int neighborX = x + WALL_OFFSETS[i].x;
+        int neighborZ = z + WALL_OFFSETS[i].y;
+        float bottom = heights[(neighborX + 1) * SAMPLES + neighborZ + 1] + 1;
+
+        // Tiles next to this one can be at another level, the border walls hang below both tops to cover the gaps
+        bool border = neighborX < 0 || neighborX >= CELLS || neighborZ < 0 || neighborZ >= CELLS;
+        if (border) bottom = std::min(bottom, top) - cellSize;
+
+        if (bottom < top) {
+          AddQuad(m_meshData, WALLS[i], x0, bottom, z0, x1, top, z1, wallTextures[i]);
+        }
+      }
+    }
+  }
+
+  m_memoryUsage = m_meshData.vertices.size() * sizeof(float) + m_meshData.indices.size() * sizeof(unsigned int);
+  a_generated = true;
+}
+
+void LodTile::ApplyMesh(RenderBackend* backend) {
+  if (backend != nullptr) {
+    m_mesh = backend->CreateMeshBuffers();
+    m_mesh->SetData(m_meshData);
+  }
+  m_meshData = {};
+  m_applied = true;
+}
+
+const MeshBuffers* LodTile::GetMeshBuffers() const {
+  return m_mesh.get();
+}
+
+bool LodTile::IsGenerated() const {
+  return a_generated;
+}
+
+bool LodTile::IsApplied() const {
+  return m_applied;
+}
+
+size_t LodTile::GetMemoryUsage() const {
+  // Set before a_generated, so it's complete once a_generated is
+  return a_generated ? m_memoryUsage : MAX_QUADS * QUAD_SIZE;
+}
+
+int LodTile::GetLevel() const {
+  return m_level;
+}
+
+int LodTile::GetSize() const {
+  return 1 << m_level;
+}
+
+glm::ivec2 LodTile::GetFirstChunk() const {
+  return m_tileCoord * GetSize();
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <glm/vec2.hpp>
+
+#include "util/ClassMacros.h"
+#include "Chunk.h"
+#include "RenderBackend.h"
+
+class WorldGenerator;
+
+// Stand-in for the terrain beyond the render distance, made from the heightmap alone. A tile at level L covers
+// 2^L x 2^L chunks with CELLS x CELLS columns, each as tall as the terrain at its corner, so far tiles cover more
+// ground for the same cost
+class LodTile {
+public:
+  DELETE_COPY(LodTile);
+
+  static const int CELLS = 8;
+  static const int MAX_LEVEL = 4;
+
+  LodTile(int level, glm::ivec2 tileCoord);
+
+  // Samples the heights and builds the mesh data, safe to call from a worker
+  void Generate(const WorldGenerator& generator);
+  // Uploads the generated mesh with the backend (if any), render thread only
+  void ApplyMesh(RenderBackend* backend);
+  // Null until the tile is applied, or when the world has no render backend
+  const MeshBuffers* GetMeshBuffers() const;
+
+  bool IsGenerated() const;
+  bool IsApplied() const;
+  // Bytes of vertex and index data, the upper bound until the tile is generated
+  size_t GetMemoryUsage() const;
+
+  int GetLevel() const;
+  // Width in chunks
+  int GetSize() const;
+  glm::ivec2 GetFirstChunk() const;
+
+  std::atomic<bool> a_queued = false;
+private:
+  int m_level;
+  glm::ivec2 m_tileCoord;
+
+  MeshData m_meshData;
+  std::unique_ptr<MeshBuffers> m_mesh;
+  size_t m_memoryUsage;
+
+  std::atomic<bool> a_generated = false;
+  bool m_applied = false;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+struct MeshData {
+  std::vector<float> vertices;
+  std::vector<unsigned int> indices;
+  // Quads left degenerate by patches, the subchunk is remeshed once they are half of it
+  int unusedQuads = 0;
+};
+
+// GPU copy of a MeshData, made by the render backend. Unloaded chunks free theirs on a worker thread, so destroying
+// one must not need the graphics context
+class MeshBuffers {
+public:
+  virtual ~MeshBuffers() = default;
+
+  // Replaces the whole mesh. The buffers get room for at least the given number of floats and indices, so later
+  // patches can grow the mesh in place
+  virtual void SetData(const MeshData& data, size_t vertexCapacity = 0, size_t indexCapacity = 0) = 0;
+  // Replaces part of the vertices and indices in place and draws `totalIndexCount` indices from then on.
+  // Returns false without changing anything if the data doesn't fit in the buffers
+  virtual bool PatchData(const float* vertices, size_t vertexOffset, size_t vertexCount,
+    const unsigned int* indices, size_t indexOffset, size_t indexCount, size_t totalIndexCount) = 0;
+};
+
+// GPU copy of a subchunk's light volume, a cube of RGBA cells. Freed like MeshBuffers
+class LightVolumeBuffer {
+public:
+  virtual ~LightVolumeBuffer() = default;
+
+  virtual void SetData(int size, const unsigned char* cells) = 0;
+};
+
+// Makes the GPU objects the world uploads its meshes into. The world itself never talks to a graphics API, without
+// a backend it still generates the mesh data but uploads nothing, so it runs on headless servers and in benchmarks.
+// Only used from the thread that calls World::Update
+class RenderBackend {
+public:
+  virtual ~RenderBackend() = default;
+
+  virtual std::unique_ptr<MeshBuffers> CreateMeshBuffers() = 0;
+  virtual std::unique_ptr<LightVolumeBuffer> CreateLightVolume() = 0;
+};
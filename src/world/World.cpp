@@ -2,15 +2,14 @@
 #include <thread>
 #include <functional>
 #include <unordered_set>
-
-#include <glad/glad.h>
+#include <algorithm>
+#include <filesystem>
+#include <sstream>
 
 #include "World.h"
 #include "Chunk.h"
 #include "util/MathUtil.h"
 #include "util/Logging.h"
-#include "../engine/rendering/ShaderLibrary.h"
-#include "../engine/rendering/buffers/ResourceGraveyard.h"
 #include "../voxel/VoxelData.h"
 
 #include "../debug/DebugSettings.h"
@@ -19,10 +18,47 @@
 namespace {
 glm::ivec2 chunkOffsetsWithCorners[] = { {0, 0}, {0, 1}, {1, 0}, {0, -1}, {-1, 0}, {-1, -1}, {1, -1}, {1, 1}, {-1, 1} };
 
+// A chunk's terrain is only final once its neighbors placed their structures, and it can only be lit once its
+// neighbors' terrain is final, so every chunk two chunks away is involved
+std::vector<glm::ivec2> CreateChunkOffsetsWithin(int radius) {
+  std::vector<glm::ivec2> offsets;
+  for (int x = -radius; x <= radius; x++) {
+    for (int z = -radius; z <= radius; z++) {
+      offsets.push_back({ x, z });
+    }
+  }
+  return offsets;
+}
+
+const std::vector<glm::ivec2> chunkOffsetsWithin2 = CreateChunkOffsetsWithin(2);
+
 long GetDistanceToChunk(int diffX, int diffZ) {
   return std::abs(diffX) * std::abs(diffX) + std::abs(diffZ) * std::abs(diffZ);
 }
 
+// Walks the LOD quadtree down from a tile, collecting the tiles to draw with their squared distance. A tile is split
+// while its closest chunk is nearer than the render distance times its size, so every level covers a ring twice as
+// wide as the one inside it, and the single chunk tiles next to the render distance are left to the real chunks
+void CollectLodTiles(int level, glm::ivec2 tileCoord, glm::ivec2 playerChunk, int renderDistance, int lodDistance, std::vector<std::pair<long, glm::ivec3>>& tiles) {
+  int size = 1 << level;
+  glm::ivec2 firstChunk = tileCoord * size;
+  glm::ivec2 closest = glm::clamp(playerChunk, firstChunk, firstChunk + size - 1);
+  long distance = GetDistanceToChunk(closest.x - playerChunk.x, closest.y - playerChunk.y);
+
+  if (distance >= (long)lodDistance * lodDistance) return;
+
+  long splitDistance = (long)renderDistance * size;
+  if (level > 0 && distance < splitDistance * splitDistance) {
+    for (int x = 0; x < 2; x++) {
+      for (int z = 0; z < 2; z++) {
+        CollectLodTiles(level - 1, tileCoord * 2 + glm::ivec2(x, z), playerChunk, renderDistance, lodDistance, tiles);
+      }
+    }
+  } else if (distance >= (long)renderDistance * renderDistance) {
+    tiles.push_back({ distance, { tileCoord.x, level, tileCoord.y } });
+  }
+}
+
 } // namespace
 
 void chunkTerrainGeneratorWorker(World& world, int workerId) {
@@ -33,18 +69,33 @@ void chunkTerrainGeneratorWorker(World& world, int workerId) {
 
     // Chunks could have been deleted, so obtain a valid pointer if one exists
     if (auto chunk = weakChunk.lock()) {
-      if (chunk->GetState() < GENERATED_TERRAIN) {
-        chunk->GenerateTerrain();
+      // Saved chunks take priority over the terrain cache, which only holds unedited chunks.
+      // Regenerated chunks are already loaded, and their storage could be older than their edits
+      if (chunk->GetState() < GENERATED_STRUCTURES) {
+        // With only a few chunks left, as around the spawn, most cores would sit idle, so split the chunk to finish
+        // it sooner instead
+        bool parallel = world.m_chunksToGenerateTerrain.size() < DebugSettings::instance.parallelGenerationQueueDepth;
+
+        if (chunk->IsRegenerating()) {
+          chunk->RegenerateTerrain(parallel);
+        } else if (!world.LoadChunkFromStorage(*chunk) && !world.LoadChunkFromCache(*chunk)) {
+          chunk->GenerateTerrain(parallel);
+        }
       }
 
-      // Check if a neighboring chunk, or this one, is ready for lighting
+      // This chunk's structures could have been the last ones a neighbor, or this chunk, was waiting for
       glm::ivec2 centerCoord = chunk->GetChunkCoord();
       for (const glm::ivec2& offset : chunkOffsetsWithCorners) {
+        world.TryFinishTerrain(centerCoord + offset);
+      }
+
+      // Check if any chunk whose neighbors could have been finished is ready for lighting
+      for (const glm::ivec2& offset : chunkOffsetsWithin2) {
         glm::ivec2 chunkCoord = centerCoord + offset;
 
         // Check all the neighbors
         std::shared_ptr<Chunk> currChunk = world.GetChunkAt(chunkCoord);
-        if (currChunk == nullptr) {
+        if (currChunk == nullptr || currChunk->a_queuedLighting) {
           continue;
         }
 
@@ -129,6 +180,46 @@ void chunkMeshGeneratorWorker(World& world, int workerId) {
   LOG(EXTRA) << "Chunk mesh generator worker #" << workerId << " stopped";
 }
 
+void chunkReclaimerWorker(World& world) {
+  while (true) {
+    ChunkMap::NodeHandle node;
+    if (!world.m_chunksToReclaim.pop(node)) break;
+
+    std::shared_ptr<Chunk>& chunk = node.mapped();
+    if (chunk->a_modified) {
+      world.SaveChunkToStorage(*chunk);
+
+      std::lock_guard<std::mutex> lock(world.m_pendingSavesMutex);
+      auto it = world.m_pendingSaves.find(node.key());
+      if (it != world.m_pendingSaves.end() && it->second == chunk) {
+        world.m_pendingSaves.erase(it);
+      }
+    } else if (chunk->IsCacheable()) {
+      world.SaveChunkToCache(*chunk);
+    }
+
+    // Dropping the node here frees the chunk (if no other worker still holds it), its arrays and its meshes.
+    // The render backend's buffers are made to be destroyed off the render thread, see MeshBuffers
+  }
+
+  LOG(EXTRA) << "Chunk reclaimer worker stopped";
+}
+
+void lodTileWorker(World& world, int workerId) {
+  while (true) {
+    std::weak_ptr<LodTile> weakTile;
+    if (!world.m_lodTilesToGenerate.pop(weakTile)) break;
+
+    // Tiles the player moved away from are dropped before they're generated
+    if (auto tile = weakTile.lock()) {
+      tile->Generate(*world.m_generator);
+      world.m_lodTilesToApply.push(tile);
+    }
+  }
+
+  LOG(EXTRA) << "LOD tile worker #" << workerId << " stopped";
+}
+
 World::World(const Entity& trackingEntity) : m_trackingEntity(trackingEntity) {}
 
 World::~World() {
@@ -136,10 +227,26 @@ World::~World() {
 }
 
 void World::Start() {
+  // No workers are running yet, so the generator can be replaced safely
+  m_generator = std::make_unique<WorldGenerator>(DebugSettings::instance);
+
+  for (size_t i = 0; i < m_generationStageHashes.size(); i++) {
+    m_generationStageHashes[i] = DebugSettings::instance.GetGenerationStageHash((GenerationStage)i);
+  }
+
+  if (DebugSettings::instance.saveWorld) {
+    m_storage = std::make_unique<WorldStorage>(DebugSettings::instance.saveDirectory + "/region");
+  }
+  if (DebugSettings::instance.useTerrainCache) {
+    OpenTerrainCache();
+  }
+
   // Make sure the work queues are active
   m_chunksToGenerateMesh.start();
   m_chunksToGenerateTerrain.start();
   m_chunksToPropagateLighting.start();
+  m_chunksToReclaim.start();
+  m_lodTilesToGenerate.start();
 
   // Generate the worker threads
   for (int i = 0; i < DebugSettings::instance.terrainWorkerCount; i++) {
@@ -157,6 +264,14 @@ void World::Start() {
       chunkMeshGeneratorWorker(*this, i);
     }));
   }
+  m_workerThreads.push_back(std::thread([this]() {
+    chunkReclaimerWorker(*this);
+  }));
+  for (int i = 0; i < DebugSettings::instance.lodWorkerCount; i++) {
+    m_workerThreads.push_back(std::thread([this, i]() {
+      lodTileWorker(*this, i);
+    }));
+  }
 
 }
 
@@ -165,6 +280,8 @@ void World::Stop() {
   m_chunksToPropagateLighting.stop();
   m_chunksToGenerateTerrain.stop();
   m_chunksToGenerateMesh.stop();
+  m_chunksToReclaim.stop();
+  m_lodTilesToGenerate.stop();
 
   for (auto& thread : m_workerThreads) {
     if (thread.joinable()) {
@@ -179,16 +296,38 @@ void World::Stop() {
   m_chunksToPropagateLighting.clear();
   m_chunksToGenerateMesh.clear();
   m_chunksToApplyMesh.clear();
+  m_chunksToReclaim.clear();
+  m_chunkCoordsToUnload.clear();
+  m_activeChunks.clear();
+  m_lastPlayerChunk = std::nullopt;
+  m_lastSortBlock = std::nullopt;
+
+  m_lodTilesToGenerate.clear();
+  m_lodTilesToApply.clear();
+  m_activeLodTiles.clear();
+  m_lodTiles.clear();
+
+  // The workers are stopped, so whatever is still modified gets saved here
+  for (auto& [coord, chunk] : m_pendingSaves) {
+    SaveChunkToStorage(*chunk);
+  }
+  m_pendingSaves.clear();
+  m_chunks.forEach([&](glm::ivec2 coord, std::shared_ptr<Chunk> chunk) {
+    SaveChunkToStorage(*chunk);
+  });
+  m_storage.reset();
+  m_terrainCache.reset();
 
   // Clear the chunks
   m_chunks.clear();
-  ResourceGraveyard::GetInstance().Flush();
 }
 
 void World::ResetWorkers() {
   m_chunksToGenerateTerrain.stop();
   m_chunksToPropagateLighting.stop();
   m_chunksToGenerateMesh.stop();
+  m_chunksToReclaim.stop();
+  m_lodTilesToGenerate.stop();
 
   for (auto& thread : m_workerThreads) {
     if (thread.joinable()) {
@@ -207,19 +346,93 @@ void World::Update() {
 
   int renderDistance = DebugSettings::instance.renderDistance;
   int inMemoryRadius = renderDistance + DebugSettings::instance.inMemoryBorder;
+  int lodDistance = DebugSettings::instance.lodDistance;
 
-  std::vector<glm::ivec2> chunksCoordsToUnload;
+  // The active set only changes when the player crosses into another chunk or the distances change
+  if (!m_lastPlayerChunk.has_value() || *m_lastPlayerChunk != playerChunk || m_lastRenderDistance != renderDistance || m_lastInMemoryRadius != inMemoryRadius || m_lastLodDistance != lodDistance) {
+    UpdateLodTiles(playerChunk, renderDistance, lodDistance);
+    UpdateActiveChunks(playerChunk, renderDistance, inMemoryRadius);
+  }
 
-  m_chunks.forEach([&](glm::ivec2 coord, std::shared_ptr<Chunk> chunk) {
-    chunk->SetActive(false);
+  glm::dvec3 eye = m_trackingEntity.GetPosition() + glm::dvec3(0.0, m_trackingEntity.GetEyeLevel(), 0.0);
+  glm::ivec3 eyeBlock = glm::floor(eye);
+  if (!m_lastSortBlock.has_value() || *m_lastSortBlock != eyeBlock) {
+    m_lastSortBlock = eyeBlock;
+    m_translucentSortEye = eye;
+    for (const std::shared_ptr<Chunk>& chunk : m_activeChunks) {
+      chunk->SortTranslucentQuads(m_translucentSortEye);
+    }
+  }
 
-    if (std::abs(coord.x - playerChunk.x) > inMemoryRadius || std::abs(coord.y - playerChunk.y) > inMemoryRadius) {
-      chunksCoordsToUnload.push_back(coord);
+  // Go through the chunks that need to be generated
+  while (!m_chunkGenerationQueue.empty()) {
+    // Chunks that need to be generated in order to make the mesh for the chunk at 0, 0
+    DistanceToChunk distanceToChunk = m_chunkGenerationQueue.top();
+    m_chunkGenerationQueue.pop();
+
+    Chunk* centerChunk = distanceToChunk.second;
+    glm::ivec2 centerCoord = centerChunk->GetChunkCoord();
+
+    // We need to generate the terrain for this chunk, its neighbors and their neighbors
+    for (const glm::ivec2& offset : chunkOffsetsWithin2) {
+      glm::ivec2 chunkCoord = centerCoord + offset;
+      std::shared_ptr<Chunk> chunk = GetOrCreateChunkAt(chunkCoord);
+
+      if (!chunk->a_queuedTerrain.exchange(true)) {
+        // long distance = GetDistanceToChunk(chunkCoord, playerChunk);
+        m_chunksToGenerateTerrain.push(chunk);
+      }
     }
-  });
+  }
 
+  while (!m_chunksToApplyMesh.empty()) {
+    std::weak_ptr<Chunk> weakChunk;
+    m_chunksToApplyMesh.pop(weakChunk);
+
+    if (auto chunk = weakChunk.lock()) {
+      chunk->ApplyMesh();
+    }
+  }
+
+  // Uploads are bounded too, a far away tile can wait a frame
+  for (int i = 0; i < DebugSettings::instance.maxLodUploadsPerFrame && !m_lodTilesToApply.empty(); i++) {
+    std::weak_ptr<LodTile> weakTile;
+    m_lodTilesToApply.pop(weakTile);
+
+    if (auto tile = weakTile.lock()) {
+      tile->ApplyMesh(m_renderBackend);
+    }
+  }
+
+  // Unload a bounded batch of chunks per frame, the rest will be picked up on the following frames.
+  // The map node is only unlinked here and handed to the reclaimer, so nothing is freed on this thread
+  for (int i = 0; i < DebugSettings::instance.maxChunkUnloadsPerFrame && !m_chunkCoordsToUnload.empty(); i++) {
+    RemoveChunk(m_chunkCoordsToUnload.back());
+    m_chunkCoordsToUnload.pop_back();
+  }
+}
+
+void World::UpdateActiveChunks(glm::ivec2 playerChunk, int renderDistance, int inMemoryRadius) {
+  bool hadPreviousSet = m_lastPlayerChunk.has_value();
+  glm::ivec2 lastPlayerChunk = m_lastPlayerChunk.value_or(playerChunk);
+  int lastRenderDistance2 = m_lastRenderDistance * m_lastRenderDistance;
   int renderDistance2 = renderDistance * renderDistance;
 
+  auto isInCircle = [](glm::ivec2 coord, glm::ivec2 center, int radius2) {
+    glm::ivec2 diff = coord - center;
+    return diff.x * diff.x + diff.y * diff.y < radius2;
+  };
+
+  // Deactivate the chunks that left the render distance "circle"
+  auto firstInactive = std::partition(m_activeChunks.begin(), m_activeChunks.end(), [&](const std::shared_ptr<Chunk>& chunk) {
+    return isInCircle(chunk->GetChunkCoord(), playerChunk, renderDistance2);
+  });
+  for (auto it = firstInactive; it != m_activeChunks.end(); it++) {
+    (*it)->SetActive(false);
+  }
+  m_activeChunks.erase(firstInactive, m_activeChunks.end());
+
+  // Activate the chunks that entered it
   for (int x = -renderDistance; x <= renderDistance; x++) {
     for (int z = -renderDistance; z <= renderDistance; z++) {
 
@@ -231,8 +444,13 @@ void World::Update() {
       glm::ivec2 chunkCoord(x, z);
       chunkCoord += playerChunk;
 
+      if (hadPreviousSet && isInCircle(chunkCoord, lastPlayerChunk, lastRenderDistance2)) {
+        continue;
+      }
+
       std::shared_ptr<Chunk> chunk = GetOrCreateChunkAt(chunkCoord);
       chunk->SetActive(true);
+      m_activeChunks.push_back(chunk);
 
       // Queue the chunk for generation if it hasnt been already queued
       if (!chunk->m_queuedGeneration) {
@@ -243,46 +461,158 @@ void World::Update() {
     }
   }
 
-  // Go through the chunks that need to be generated
-  while (!m_chunkGenerationQueue.empty()) {
-    // Chunks that need to be generated in order to make the mesh for the chunk at 0, 0
-    DistanceToChunk distanceToChunk = m_chunkGenerationQueue.top();
-    m_chunkGenerationQueue.pop();
+  // Collect the chunks that fell out of memory range, Update unloads them in batches
+  m_chunkCoordsToUnload.clear();
+  m_chunks.forEach([&](glm::ivec2 coord, std::shared_ptr<Chunk> chunk) {
+    if (std::abs(coord.x - playerChunk.x) > inMemoryRadius || std::abs(coord.y - playerChunk.y) > inMemoryRadius) {
+      m_chunkCoordsToUnload.push_back(coord);
+    }
+  });
 
-    Chunk* centerChunk = distanceToChunk.second;
-    glm::ivec2 centerCoord = centerChunk->GetChunkCoord();
+  // Drawn nearest first so the depth test rejects most of the hidden faces before shading them
+  std::sort(m_activeChunks.begin(), m_activeChunks.end(), [&](const std::shared_ptr<Chunk>& a, const std::shared_ptr<Chunk>& b) {
+    glm::ivec2 diffA = a->GetChunkCoord() - playerChunk;
+    glm::ivec2 diffB = b->GetChunkCoord() - playerChunk;
+    return diffA.x * diffA.x + diffA.y * diffA.y < diffB.x * diffB.x + diffB.y * diffB.y;
+  });
 
-    // We need to generate the terrain for this chunk and all other adjacent chunks
-    for (const glm::ivec2& offset : chunkOffsetsWithCorners) {
-      glm::ivec2 chunkCoord = centerCoord + offset;
-      std::shared_ptr<Chunk> chunk = GetOrCreateChunkAt(chunkCoord);
+  m_lastPlayerChunk = playerChunk;
+  m_lastRenderDistance = renderDistance;
+  m_lastInMemoryRadius = inMemoryRadius;
+}
 
-      if (!chunk->a_queuedTerrain.exchange(true)) {
-        // long distance = GetDistanceToChunk(chunkCoord, playerChunk);
-        m_chunksToGenerateTerrain.push(chunk);
+void World::UpdateLodTiles(glm::ivec2 playerChunk, int renderDistance, int lodDistance) {
+  m_lastLodDistance = lodDistance;
+
+  std::vector<std::pair<long, glm::ivec3>> tileKeys;
+  if (lodDistance > renderDistance) {
+    int rootSize = 1 << LodTile::MAX_LEVEL;
+    glm::ivec2 firstRoot = { MathUtil::FloorDiv(playerChunk.x - lodDistance, rootSize), MathUtil::FloorDiv(playerChunk.y - lodDistance, rootSize) };
+    glm::ivec2 lastRoot = { MathUtil::FloorDiv(playerChunk.x + lodDistance, rootSize), MathUtil::FloorDiv(playerChunk.y + lodDistance, rootSize) };
+
+    for (int x = firstRoot.x; x <= lastRoot.x; x++) {
+      for (int z = firstRoot.y; z <= lastRoot.y; z++) {
+        CollectLodTiles(LodTile::MAX_LEVEL, { x, z }, playerChunk, renderDistance, lodDistance, tileKeys);
       }
     }
   }
+  std::sort(tileKeys.begin(), tileKeys.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  // Tiles that aren't generated yet are assumed to be as big as the average generated one
+  size_t generatedMemory = 0;
+  int generatedCount = 0;
+  for (const std::shared_ptr<LodTile>& tile : m_activeLodTiles) {
+    if (tile->IsGenerated()) {
+      generatedMemory += tile->GetMemoryUsage();
+      generatedCount++;
+    }
+  }
 
-  while (!m_chunksToApplyMesh.empty()) {
-    std::weak_ptr<Chunk> weakChunk;
-    m_chunksToApplyMesh.pop(weakChunk);
+  // Nearest first, so the budget cuts off the horizon
+  size_t budget = (size_t)DebugSettings::instance.lodMemoryBudgetMB * 1024 * 1024;
+  size_t usedMemory = 0;
+  LodTileMap tiles;
+  m_activeLodTiles.clear();
 
-    if (auto chunk = weakChunk.lock()) {
-      chunk->ApplyMesh();
+  for (const auto& [distance, key] : tileKeys) {
+    auto it = m_lodTiles.find(key);
+    std::shared_ptr<LodTile> tile = it != m_lodTiles.end() ? it->second : std::make_shared<LodTile>(key.y, glm::ivec2(key.x, key.z));
+
+    size_t memory = tile->IsGenerated() || generatedCount == 0 ? tile->GetMemoryUsage() : generatedMemory / generatedCount;
+    if (usedMemory + memory > budget) break;
+    usedMemory += memory;
+
+    if (!tile->a_queued.exchange(true)) {
+      m_lodTilesToGenerate.push(tile);
+    }
+    tiles[key] = tile;
+    m_activeLodTiles.push_back(tile);
+  }
+
+  // Dropping the tiles that aren't needed anymore also drops them from the queues, which only hold weak pointers
+  m_lodTiles = std::move(tiles);
+}
+
+void World::Regenerate() {
+  std::optional<GenerationStage> firstChangedStage;
+  for (size_t i = 0; i < m_generationStageHashes.size(); i++) {
+    if (DebugSettings::instance.GetGenerationStageHash((GenerationStage)i) != m_generationStageHashes[i]) {
+      firstChangedStage = (GenerationStage)i;
+      break;
     }
   }
 
-  for (glm::ivec2 coord : chunksCoordsToUnload) {
-    m_chunks.erase(coord);
+  // A new seed changes every stage, so nothing can be kept
+  if (!m_generator || !firstChangedStage.has_value() || DebugSettings::instance.seed != m_generator->GetSeed()) {
+    // Reset all known information about the world
+    Stop();
+    Start();
+    return;
   }
 
-  ResourceGraveyard::GetInstance().Flush();
+  LOG(INFO) << "Regenerating the world from the " << GetGenerationStageName(*firstChangedStage) << " stage";
+  RegenerateFrom(*firstChangedStage);
 }
 
-void World::Regenerate() {
-  // Reset all known information about the world
-  Stop();
+void World::RegenerateFrom(GenerationStage firstStage) {
+  m_chunksToGenerateTerrain.stop();
+  m_chunksToPropagateLighting.stop();
+  m_chunksToGenerateMesh.stop();
+  m_chunksToReclaim.stop();
+  m_lodTilesToGenerate.stop();
+
+  for (auto& thread : m_workerThreads) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+  m_workerThreads.clear();
+
+  // The reclaimer would put the chunks still waiting for it into the new terrain cache, but they were made with the
+  // old settings. The modified ones get saved here as the reclaimer would, the rest are dropped
+  for (auto& [coord, chunk] : m_pendingSaves) {
+    SaveChunkToStorage(*chunk);
+  }
+  m_pendingSaves.clear();
+  m_chunksToReclaim.clear();
+
+  // Every resident chunk goes through the pipeline again
+  m_chunkGenerationQueue = {};
+  m_chunksToGenerateTerrain.clear();
+  m_chunksToPropagateLighting.clear();
+  m_chunksToGenerateMesh.clear();
+  m_chunksToApplyMesh.clear();
+  while (m_firstDirtyChunk != nullptr) {
+    Chunk* chunk = m_firstDirtyChunk;
+    m_firstDirtyChunk = chunk->m_nextDirtyChunk;
+    chunk->m_nextDirtyChunk = nullptr;
+    chunk->m_inDirtyList = false;
+  }
+
+  m_chunks.forEach([&](glm::ivec2 coord, std::shared_ptr<Chunk> chunk) {
+    chunk->ResetGeneration(firstStage);
+  });
+
+  // Far tiles only use the heightmap. Tiles still waiting in the cleared queues are made again by the next update
+  m_lodTilesToGenerate.clear();
+  m_lodTilesToApply.clear();
+  m_activeLodTiles.clear();
+  for (auto it = m_lodTiles.begin(); it != m_lodTiles.end();) {
+    if (firstStage == GenerationStage::HEIGHTMAP || !it->second->IsApplied()) {
+      it = m_lodTiles.erase(it);
+    } else {
+      it++;
+    }
+  }
+
+  // Queues the visible chunks for generation again on the next update
+  for (const std::shared_ptr<Chunk>& chunk : m_activeChunks) {
+    chunk->SetActive(false);
+  }
+  m_activeChunks.clear();
+  m_lastPlayerChunk = std::nullopt;
+
+  // Also opens the terrain cache for the new settings
   Start();
 }
 
@@ -302,16 +632,63 @@ int World::GetChunksToGenerateMeshSize() const {
   return m_chunksToGenerateMesh.size();
 }
 
+int World::GetChunksToReclaimSize() const {
+  return m_chunksToReclaim.size();
+}
+
+int World::GetLodTileCount() const {
+  return m_activeLodTiles.size();
+}
+
+int World::GetLodTilesToGenerateSize() const {
+  return m_lodTilesToGenerate.size();
+}
+
+size_t World::GetLodMemoryUsage() const {
+  size_t memory = 0;
+  for (const std::shared_ptr<LodTile>& tile : m_activeLodTiles) {
+    if (tile->IsApplied()) memory += tile->GetMemoryUsage();
+  }
+  return memory;
+}
+
 const Entity& World::GetTrackingEntity() const {
   return m_trackingEntity;
 }
 
+const WorldGenerator& World::GetGenerator() const {
+  return *m_generator;
+}
+
+glm::vec3 World::GetTranslucentSortEye() const {
+  return m_translucentSortEye;
+}
+
+void World::SetRenderBackend(RenderBackend* backend) {
+  m_renderBackend = backend;
+}
+
+RenderBackend* World::GetRenderBackend() const {
+  return m_renderBackend;
+}
+
+const std::vector<std::shared_ptr<Chunk>>& World::GetActiveChunks() const {
+  return m_activeChunks;
+}
+
+const std::vector<std::shared_ptr<LodTile>>& World::GetActiveLodTiles() const {
+  return m_activeLodTiles;
+}
+
 void World::MarkChunkDirty(Chunk* chunk) {
-  m_dirtyChunks.insert(chunk);
+  if (chunk->m_inDirtyList) return;
+  chunk->m_inDirtyList = true;
+  chunk->m_nextDirtyChunk = m_firstDirtyChunk;
+  m_firstDirtyChunk = chunk;
 }
 
-void World::MarkPositionDirty(const glm::ivec3& globalPosition) const {
-  GetChunkAtBlockPos(globalPosition.x, globalPosition.z)->MarkPositionDirty(ToLocalCoords(globalPosition));
+void World::MarkPositionDirty(const glm::ivec3& globalPosition, bool lightOnly) const {
+  GetChunkAtBlockPos(globalPosition.x, globalPosition.z)->MarkPositionDirty(ToLocalCoords(globalPosition), lightOnly);
 }
 
 Blockstate World::GetBlockstateAt(int globalX, int globalY, int globalZ) const {
@@ -346,29 +723,92 @@ void World::SetLightAt(LightType type, int globalX, int globalY, int globalZ, ch
   }
 }
 
-void World::Draw() const {
-  Shader& shader = ShaderLibrary::GetInstance().Get("main");
-  shader.Use();
-  shader.LoadBool("nightVision", DebugSettings::instance.nightVision);
-  shader.LoadBool("nightTime", DebugSettings::instance.nightTime);
-  Blocks::GetAtlas().Use();
-  m_chunks.forEach([&](glm::ivec2 coord, std::shared_ptr<Chunk> chunk) {
-    chunk->Draw(shader);
+std::shared_ptr<Chunk> World::GetOrCreateChunkAt(glm::ivec2 chunkCoord) {
+  // Create the chunk if it doesnt exist
+  return m_chunks.getOrInsert(chunkCoord, [&]() {
+    return std::make_shared<Chunk>(chunkCoord, *this);
   });
 }
 
-std::shared_ptr<Chunk> World::GetOrCreateChunkAt(glm::ivec2 chunkCoord) {
-  std::shared_ptr<Chunk> chunk;
+void World::TryFinishTerrain(glm::ivec2 chunkCoord) {
+  std::shared_ptr<Chunk> chunk = GetChunkAt(chunkCoord);
+  if (chunk == nullptr || chunk->GetState() != GENERATED_STRUCTURES || chunk->a_queuedFinish) return;
 
-  // Create the chunk if it doesnt exist
-  if (!m_chunks.contains(chunkCoord)) {
-    chunk = std::make_shared<Chunk>(chunkCoord, *this);
-    m_chunks.insert(chunkCoord, chunk);
-  } else {
-    chunk = m_chunks.get(chunkCoord).value();
+  for (const glm::ivec2& offset : chunkOffsetsWithCorners) {
+    std::shared_ptr<Chunk> neighborChunk = GetChunkAt(chunkCoord + offset);
+    if (neighborChunk == nullptr || neighborChunk->GetState() < GENERATED_STRUCTURES) return;
   }
 
-  return chunk;
+  if (!chunk->a_queuedFinish.exchange(true)) {
+    chunk->FinishTerrain();
+  }
+}
+
+bool World::LoadChunkFromStorage(Chunk& chunk) {
+  if (!m_storage) return false;
+
+  glm::ivec2 chunkCoord = chunk.GetChunkCoord();
+
+  std::shared_ptr<Chunk> pendingChunk;
+  {
+    std::lock_guard<std::mutex> lock(m_pendingSavesMutex);
+    auto it = m_pendingSaves.find(chunkCoord);
+    if (it != m_pendingSaves.end()) pendingChunk = it->second;
+  }
+
+  if (pendingChunk) {
+    return chunk.LoadTerrain(pendingChunk->Serialize());
+  }
+
+  std::optional<std::vector<unsigned char>> payload = m_storage->LoadChunk(chunkCoord);
+  if (!payload.has_value()) return false;
+
+  if (!chunk.LoadTerrain(*payload)) {
+    LOG(ERROR) << "Stored chunk at " << chunkCoord.x << ", " << chunkCoord.y << " is corrupt, regenerating it";
+    return false;
+  }
+  return true;
+}
+
+void World::SaveChunkToStorage(Chunk& chunk) {
+  if (!m_storage || !chunk.a_modified.exchange(false)) return;
+
+  glm::ivec2 chunkCoord = chunk.GetChunkCoord();
+  if (!m_storage->SaveChunk(chunkCoord, chunk.Serialize())) {
+    LOG(ERROR) << "Failed to save chunk at " << chunkCoord.x << ", " << chunkCoord.y;
+  }
+}
+
+bool World::LoadChunkFromCache(Chunk& chunk) {
+  if (!m_terrainCache) return false;
+
+  std::optional<std::vector<unsigned char>> payload = m_terrainCache->LoadChunk(chunk.GetChunkCoord());
+  return payload.has_value() && chunk.LoadCache(*payload);
+}
+
+void World::SaveChunkToCache(Chunk& chunk) {
+  if (!m_terrainCache) return;
+  m_terrainCache->SaveChunk(chunk.GetChunkCoord(), chunk.SerializeCache());
+}
+
+void World::OpenTerrainCache() {
+  std::stringstream key;
+  key << DebugSettings::instance.seed << "-" << std::hex << DebugSettings::instance.GetTerrainSettingsHash();
+
+  std::filesystem::path root = DebugSettings::instance.terrainCacheDirectory;
+  std::filesystem::path directory = root / key.str();
+
+  // Caches made with other settings can't be used anymore
+  std::error_code error;
+  if (std::filesystem::is_directory(root, error)) {
+    for (const auto& entry : std::filesystem::directory_iterator(root, error)) {
+      if (entry.path() != directory) {
+        std::filesystem::remove_all(entry.path(), error);
+      }
+    }
+  }
+
+  m_terrainCache = std::make_unique<WorldStorage>(directory.string());
 }
 
 std::shared_ptr<Chunk> World::GetChunkAt(glm::ivec2 chunkCoord) const {
@@ -408,23 +848,30 @@ glm::ivec3 World::ToLocalCoords(glm::ivec3 global) const {
 }
 
 void World::RemoveChunk(glm::ivec2 chunkCoord) {
-  m_chunks.erase(chunkCoord);
+  ChunkMap::NodeHandle node = m_chunks.extract(chunkCoord);
+  if (node) {
+    // Keep modified chunks reachable until the reclaimer has written them, in case they get loaded again right away
+    if (node.mapped()->a_modified) {
+      std::lock_guard<std::mutex> lock(m_pendingSavesMutex);
+      m_pendingSaves[chunkCoord] = node.mapped();
+    }
+    m_chunksToReclaim.push(std::move(node));
+  }
 }
 
 void World::UpdateBlockstateAt(int globalX, int globalY, int globalZ, Blockstate blockstate) {
-
-  glm::ivec3 position = { globalX, globalY, globalZ };
-  std::unordered_set<Chunk*> dirtyChunks;
-
   std::shared_ptr<Chunk> chunk = GetChunkAtBlockPos(globalX, globalZ);
   glm::ivec3 localCoords = ToLocalCoords(globalX, globalY, globalZ);
 
   Blockstate oldBlockstate = chunk->GetBlockstateAt(XYZ(localCoords));
 
   chunk->SetBlockstateAt(XYZ(localCoords), blockstate);
+  chunk->RecordEdit(localCoords, blockstate);
 
   // Mark block and neighbors as dirty (because they may need to adjust their meshes)
-  chunk->MarkPositionAndNeighborsDirty(localCoords);
+  chunk->MarkEditDirty(localCoords);
+  // The light volumes also hold which cells are open
+  if (DebugSettings::instance.useLightVolumes) chunk->MarkLightDirty(localCoords);
 
   // Recalculate lighting
   chunk->PropagateLightingAtPos(localCoords, oldBlockstate, blockstate);
@@ -437,10 +884,13 @@ std::shared_ptr<Chunk> World::GetChunkAtBlockPos(int globalX, int globalZ) const
 }
 
 void World::CleanDirtyChunks() {
-  for (Chunk* chunk : m_dirtyChunks) {
+  while (m_firstDirtyChunk != nullptr) {
+    Chunk* chunk = m_firstDirtyChunk;
+    m_firstDirtyChunk = chunk->m_nextDirtyChunk;
+    chunk->m_nextDirtyChunk = nullptr;
+    chunk->m_inDirtyList = false;
     chunk->CleanDirty();
   }
-  m_dirtyChunks.clear();
 }
 
 void World::RemeshAllChunks() {
@@ -3,18 +3,27 @@
 #include <thread>
 #include <unordered_map>
 #include <queue>
+#include <optional>
+#include <mutex>
+#include <array>
 #include <glm/vec2.hpp>
 #include "util/GlmExtensions.h"
 #include "util/ClassMacros.h"
 #include "util/threadsafe/ThreadSafeQueue.h"
 #include "util/threadsafe/ThreadSafePriorityQueue.h"
 #include "util/threadsafe/ThreadSafeUnorderedMap.h"
-#include "rendering/Shader.h"
 #include "Chunk.h"
+#include "LodTile.h"
+#include "RenderBackend.h"
+#include "storage/WorldStorage.h"
+#include "generation/WorldGenerator.h"
 #include "../entity/Entity.h"
 #include "../init/Blocks.h"
 
 using DistanceToChunk = std::pair<long, Chunk*>;
+using ChunkMap = ThreadSafeUnorderedMap<glm::ivec2, std::shared_ptr<Chunk>, IVec2Hash, IVec2Equal>;
+// Keyed by (tile x, level, tile z)
+using LodTileMap = std::unordered_map<glm::ivec3, std::shared_ptr<LodTile>, IVec3Hash, IVec3Equal>;
 
 class World {
 public:
@@ -28,17 +37,27 @@ public:
   void Update();
 
   void ResetWorkers();
+  // Runs generation again from the first stage whose settings changed, keeping the chunks and what the earlier
+  // stages made. Restarts the world if the seed or nothing in the generation changed
   void Regenerate();
 
   int GetChunkCount() const;
   int GetChunksToGenerateTerrainSize() const;
   int GetChunksToLightSize() const;
   int GetChunksToGenerateMeshSize() const;
+  int GetChunksToReclaimSize() const;
+  int GetLodTileCount() const;
+  int GetLodTilesToGenerateSize() const;
+  size_t GetLodMemoryUsage() const;
   const Entity& GetTrackingEntity() const;
+  // Only valid while the world is started
+  const WorldGenerator& GetGenerator() const;
 
   void MarkChunkDirty(Chunk* chunk);
+  // Where the translucent quads were last sorted from, in global coordinates
+  glm::vec3 GetTranslucentSortEye() const;
 
-  void MarkPositionDirty(const glm::ivec3& globalPosition) const;
+  void MarkPositionDirty(const glm::ivec3& globalPosition, bool lightOnly = false) const;
   Blockstate GetBlockstateAt(int globalX, int globalY, int globalZ) const;
   const Block& GetBlockAt(int globalX, int globalY, int globalZ) const;
   char GetLightAt(LightType type, int globalX, int globalY, int globalZ) const;
@@ -56,29 +75,82 @@ public:
   void CleanDirtyChunks();
   void RemeshAllChunks();
 
-  void Draw() const;
+  // Meshes are only uploaded while the world has a backend, which has to outlive it
+  void SetRenderBackend(RenderBackend* backend);
+  RenderBackend* GetRenderBackend() const;
+  // Chunks inside the render distance, nearest first
+  const std::vector<std::shared_ptr<Chunk>>& GetActiveChunks() const;
+  // Far terrain tiles outside the render distance
+  const std::vector<std::shared_ptr<LodTile>>& GetActiveLodTiles() const;
 
   std::shared_ptr<Chunk> GetChunkAt(glm::ivec2 chunkCoord) const;
 private:
-  ThreadSafeUnorderedMap<glm::ivec2, std::shared_ptr<Chunk>, IVec2Hash, IVec2Equal> m_chunks;
+  ChunkMap m_chunks;
 
   std::priority_queue<DistanceToChunk, std::vector<DistanceToChunk>, std::greater<DistanceToChunk>> m_chunkGenerationQueue;
   ThreadSafeQueue<std::weak_ptr<Chunk>> m_chunksToGenerateTerrain;
   ThreadSafeQueue<std::weak_ptr<Chunk>> m_chunksToPropagateLighting;
   ThreadSafeQueue<std::weak_ptr<Chunk>> m_chunksToGenerateMesh;
   ThreadSafeQueue<std::weak_ptr<Chunk>> m_chunksToApplyMesh;
-
-  // Chunks to immediately remesh (caller function must have caused the dirtyness)
-  std::unordered_set<Chunk*> m_dirtyChunks;
+  // Unloaded chunks are destroyed by a background worker so their memory is never freed on the render thread
+  ThreadSafeQueue<ChunkMap::NodeHandle> m_chunksToReclaim;
+  std::vector<glm::ivec2> m_chunkCoordsToUnload;
+
+  // Chunks inside the render distance, nearest first. Only recomputed when the player changes chunk or the distances change
+  std::vector<std::shared_ptr<Chunk>> m_activeChunks;
+  std::optional<glm::ivec2> m_lastPlayerChunk;
+  int m_lastRenderDistance = 0;
+  int m_lastInMemoryRadius = 0;
+  int m_lastLodDistance = 0;
+  // Translucent quads are only sorted again once the eye moves to another block
+  std::optional<glm::ivec3> m_lastSortBlock;
+  glm::vec3 m_translucentSortEye = { 0.0f, 0.0f, 0.0f };
+
+  // Far terrain tiles, only touched by the render thread. Their generation has its own queue and workers so it
+  // never waits behind chunks
+  LodTileMap m_lodTiles;
+  std::vector<std::shared_ptr<LodTile>> m_activeLodTiles;
+  ThreadSafeQueue<std::weak_ptr<LodTile>> m_lodTilesToGenerate;
+  ThreadSafeQueue<std::weak_ptr<LodTile>> m_lodTilesToApply;
+
+  // Chunks to immediately remesh (caller function must have caused the dirtyness), linked through the chunks
+  // themselves so marking never allocates
+  Chunk* m_firstDirtyChunk = nullptr;
 
   std::vector<std::thread> m_workerThreads;
   const Entity& m_trackingEntity;
+  RenderBackend* m_renderBackend = nullptr;
+
+  // Made from the generation settings when the world starts, shared by the terrain workers
+  std::unique_ptr<WorldGenerator> m_generator;
+  // Generation settings the resident chunks were made with
+  std::array<uint64_t, (size_t)GenerationStage::COUNT> m_generationStageHashes = {};
+
+  // Only exists while the world is started with saving enabled
+  std::unique_ptr<WorldStorage> m_storage;
+  // Only exists while the world is started with the terrain cache enabled
+  std::unique_ptr<WorldStorage> m_terrainCache;
+  // Modified chunks that were unloaded but haven't been written yet, loads read from them instead of the (stale) region file
+  std::mutex m_pendingSavesMutex;
+  std::unordered_map<glm::ivec2, std::shared_ptr<Chunk>, IVec2Hash, IVec2Equal> m_pendingSaves;
 
   std::shared_ptr<Chunk> GetOrCreateChunkAt(glm::ivec2 chunkCoord);
+  // Finishes the chunk's terrain if all its neighbors placed their structures
+  void TryFinishTerrain(glm::ivec2 chunkCoord);
+  bool LoadChunkFromStorage(Chunk& chunk);
+  void SaveChunkToStorage(Chunk& chunk);
+  bool LoadChunkFromCache(Chunk& chunk);
+  void SaveChunkToCache(Chunk& chunk);
+  void OpenTerrainCache();
+  void UpdateActiveChunks(glm::ivec2 playerChunk, int renderDistance, int inMemoryRadius);
+  void UpdateLodTiles(glm::ivec2 playerChunk, int renderDistance, int lodDistance);
+  void RegenerateFrom(GenerationStage firstStage);
 
   bool IsInsideWorld(int globalX, int globalY, int globalZ) const;
 
   friend void chunkTerrainGeneratorWorker(World& world, int workerId);
   friend void chunkMeshGeneratorWorker(World& world, int workerId);
   friend void chunkLightingWorker(World& world, int workerId);
+  friend void chunkReclaimerWorker(World& world);
+  friend void lodTileWorker(World& world, int workerId);
 };
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+
+// Terrain generation stages in the order they run. A stage only depends on the ones before it, so when a setting
+// changes only its stage and the later ones need to run again
+enum class GenerationStage {
+  HEIGHTMAP,  // column heights
+  SCULPT,     // stone, bedrock and caves
+  PAINT,      // grass, dirt and ores
+  STRUCTURES, // trees, which can reach into the neighbors
+  COUNT
+};
+
+inline const char* GetGenerationStageName(GenerationStage stage) {
+  switch (stage) {
+    case GenerationStage::HEIGHTMAP: return "heightmap";
+    case GenerationStage::SCULPT: return "sculpt";
+    case GenerationStage::PAINT: return "paint";
+    case GenerationStage::STRUCTURES: return "structures";
+    default: return "unknown";
+  }
+}
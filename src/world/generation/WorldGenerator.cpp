@@ -0,0 +1,79 @@
+#include "WorldGenerator.h"
+
+#include "util/MathUtil.h"
+#include "../../debug/DebugSettings.h"
+#include "../../init/Blocks.h"
+
+namespace {
+
+// (noise + 1) / 2 < threshold, solved for the noise
+double ThresholdToLimit(double threshold) {
+  return threshold * 2.0 - 1.0;
+}
+
+} // namespace
+
+WorldGenerator::Context& WorldGenerator::GetThreadContext() {
+  thread_local Context context;
+  return context;
+}
+
+WorldGenerator::WorldGenerator(const DebugSettings& settings) :
+  m_noise(settings.seed),
+  m_heightNoise(FractalNoise2D::FromScale(settings.noiseScale, settings.noiseOffsets[0], settings.noiseOffsets[1], settings.octaves, settings.persistence, settings.lacunarity)),
+  m_baseTerrainHeight(settings.baseTerrainHeight),
+  m_terrainRange{ settings.terrainRange[0], settings.terrainRange[1] },
+  m_caveNoise(NoiseTransform::FromScale(settings.caveNoiseScale, settings.caveNoiseOffsets[0], settings.caveNoiseOffsets[1], settings.caveNoiseOffsets[2])),
+  m_caveLimit(ThresholdToLimit(settings.caveThreshold)),
+  m_caveSpacing(settings.caveSpacing),
+  m_coalNoise(NoiseTransform::FromScale(settings.coalScale, 1000, 1000, 1000)),
+  m_coalLimit(ThresholdToLimit(settings.coalThreshold)),
+  m_coalSpacing(settings.coalSpacing),
+  m_ironNoise(NoiseTransform::FromScale(settings.ironScale, 2000, 2000, 1000)),
+  m_ironLimit(ThresholdToLimit(settings.ironThreshold)),
+  m_ironSpacing(settings.ironSpacing) {}
+
+int WorldGenerator::GetSeed() const {
+  return m_noise.GetSeed();
+}
+
+void WorldGenerator::SampleHeightmap(Context& context, int x0, int z0, int width, int depth, int* heights, int step) const {
+  int count = width * depth;
+  context.heightNoise.resize(count);
+  if (step == 1) {
+    m_noise.Noise2DGrid(context.scratch, x0, z0, width, depth, m_heightNoise, context.heightNoise.data());
+  } else {
+    // Noise2DGrid samples whole coordinates, so sample in units of the step
+    m_noise.Noise2DGrid(context.scratch, x0 / step, z0 / step, width, depth, m_heightNoise.Scaled(step), context.heightNoise.data());
+  }
+
+  for (int i = 0; i < count; i++) {
+    int terrainDifference = MathUtil::FloorToInt(MathUtil::Map(context.heightNoise[i], -1, 1, m_terrainRange[0], m_terrainRange[1]));
+    heights[i] = m_baseTerrainHeight + terrainDifference;
+  }
+}
+
+void WorldGenerator::SampleCaves(Context& context, int x0, int y0, int z0, int width, int height, int depth) const {
+  context.caves.Sample(m_noise, context.scratch, x0, y0, z0, width, height, depth, m_caveSpacing, m_caveNoise);
+}
+
+bool WorldGenerator::IsCave(const Context& context, int x, int y, int z) const {
+  return context.caves.Get(x, y, z) < m_caveLimit;
+}
+
+bool WorldGenerator::IsCaveAt(Context& context, int x, int y, int z) const {
+  context.caveProbe.Sample(m_noise, context.scratch, x, y, z, 1, 1, 1, m_caveSpacing, m_caveNoise);
+  return context.caveProbe.Get(x, y, z) < m_caveLimit;
+}
+
+void WorldGenerator::SampleOres(Context& context, int x0, int y0, int z0, int width, int height, int depth) const {
+  context.coal.Sample(m_noise, context.scratch, x0, y0, z0, width, height, depth, m_coalSpacing, m_coalNoise);
+  context.iron.Sample(m_noise, context.scratch, x0, y0, z0, width, height, depth, m_ironSpacing, m_ironNoise);
+}
+
+Blockstate WorldGenerator::GetOre(const Context& context, int x, int y, int z) const {
+  // Iron wins where both ores would be
+  if (context.iron.Get(x, y, z) < m_ironLimit) return Blocks::IRON_ORE;
+  if (context.coal.Get(x, y, z) < m_coalLimit) return Blocks::COAL_ORE;
+  return Blocks::STONE;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+
+#include "util/noise/NoiseGenerator.h"
+#include "util/noise/DensityGrid.h"
+#include "util/ClassMacros.h"
+#include "../../block/Block.h"
+
+class DebugSettings;
+
+// Terrain noise for one seed and one set of generation settings, captured when the generator is made so the settings
+// can be edited while chunks generate. Every noise transform and threshold is precomputed here, and sampling is const,
+// so any number of workers can share a generator and several worlds can generate side by side
+class WorldGenerator {
+public:
+  DELETE_COPY(WorldGenerator);
+
+  // Scratch memory for the samplers. Samples are kept here until the next call that fills them, so each thread
+  // needs its own, see GetThreadContext
+  struct Context {
+    NoiseGenerator::Scratch scratch;
+    std::vector<double> heightNoise;
+    DensityGrid caves;
+    DensityGrid caveProbe;
+    DensityGrid coal;
+    DensityGrid iron;
+  };
+
+  // The calling thread's context. It holds no generator state, so it can be used with any generator
+  static Context& GetThreadContext();
+
+  explicit WorldGenerator(const DebugSettings& settings);
+
+  int GetSeed() const;
+
+  // Terrain height of the columns (x0 + x * step, z0 + z * step) in heights[x * depth + z]. With a step, x0 and z0
+  // have to be multiples of it
+  void SampleHeightmap(Context& context, int x0, int z0, int width, int depth, int* heights, int step = 1) const;
+
+  // Samples the caves in the box, IsCave reads blocks inside it
+  void SampleCaves(Context& context, int x0, int y0, int z0, int width, int height, int depth) const;
+  bool IsCave(const Context& context, int x, int y, int z) const;
+  // Same result as IsCave for a single block, without touching the samples of SampleCaves
+  bool IsCaveAt(Context& context, int x, int y, int z) const;
+
+  // Samples the ores in the box, GetOre reads blocks inside it
+  void SampleOres(Context& context, int x0, int y0, int z0, int width, int height, int depth) const;
+  // The ore replacing stone at the position, or stone if there is none
+  Blockstate GetOre(const Context& context, int x, int y, int z) const;
+private:
+  NoiseGenerator m_noise;
+
+  FractalNoise2D m_heightNoise;
+  int m_baseTerrainHeight;
+  int m_terrainRange[2];
+
+  // A block is carved, or becomes ore, when its noise is below the limit. The thresholds are given for noise mapped
+  // to [0, 1], the limits are the same thresholds for the raw [-1, 1] noise
+  NoiseTransform m_caveNoise;
+  double m_caveLimit;
+  int m_caveSpacing;
+
+  NoiseTransform m_coalNoise;
+  double m_coalLimit;
+  int m_coalSpacing;
+
+  NoiseTransform m_ironNoise;
+  double m_ironLimit;
+  int m_ironSpacing;
+};
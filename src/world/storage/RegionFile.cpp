@@ -0,0 +1,197 @@
+#include "RegionFile.h"
+
+#include <fstream>
+#include <cstring>
+#include <filesystem>
+#include <algorithm>
+
+#include "util/MathUtil.h"
+#include "util/Logging.h"
+
+const int RegionFile::REGION_WIDTH = 32;
+const uint32_t RegionFile::SECTOR_SIZE = 4096;
+
+namespace {
+const unsigned char MAGIC[4] = { 'L', 'C', 'R', 'G' };
+const uint32_t VERSION = 1;
+
+const size_t ENTRY_COUNT = RegionFile::REGION_WIDTH * RegionFile::REGION_WIDTH;
+const size_t ENTRY_SIZE = 8;
+const size_t TABLE_OFFSET = 8;
+const size_t HEADER_SIZE = TABLE_OFFSET + ENTRY_COUNT * ENTRY_SIZE;
+
+uint32_t ReadUint32(const unsigned char* bytes) {
+  return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+void WriteUint32(unsigned char* bytes, uint32_t value) {
+  bytes[0] = value & 0xFF;
+  bytes[1] = (value >> 8) & 0xFF;
+  bytes[2] = (value >> 16) & 0xFF;
+  bytes[3] = (value >> 24) & 0xFF;
+}
+
+uint32_t RoundUpToSector(uint32_t size) {
+  return (size + RegionFile::SECTOR_SIZE - 1) / RegionFile::SECTOR_SIZE * RegionFile::SECTOR_SIZE;
+}
+
+} // namespace
+
+RegionFile::RegionFile(const std::string& path)
+  : m_path(path), m_entries(ENTRY_COUNT) {
+  Remap();
+}
+
+std::optional<std::vector<unsigned char>> RegionFile::Read(glm::ivec2 localCoord) const {
+  std::shared_lock<std::shared_mutex> lock(m_mutex);
+
+  const Entry& entry = m_entries[GetEntryIndex(localCoord)];
+  if (entry.offset == 0 || !m_mapping.has_value()) return std::nullopt;
+
+  if ((size_t)entry.offset + entry.size > m_mapping->GetSize()) {
+    LOG(ERROR) << "Region file " << m_path << " has an entry past the end of the file";
+    return std::nullopt;
+  }
+
+  const unsigned char* start = m_mapping->GetData() + entry.offset;
+  return std::vector<unsigned char>(start, start + entry.size);
+}
+
+bool RegionFile::Write(glm::ivec2 localCoord, const std::vector<unsigned char>& payload) {
+  std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+  // Only a missing file is started from scratch, an existing one that couldn't be read is never overwritten
+  bool newFile = IsMissingOrEmpty();
+  if (!newFile && !m_writable) {
+    LOG(ERROR) << "Region file " << m_path << " couldn't be read, not writing to it";
+    return false;
+  }
+
+  // Readers are locked out, drop the mapping while the file changes
+  m_mapping.reset();
+
+  if (newFile) {
+    // The chunks of a file that was removed are gone with it
+    std::fill(m_entries.begin(), m_entries.end(), Entry {});
+    m_fileSize = RoundUpToSector(HEADER_SIZE);
+
+    std::ofstream headerFile(m_path, std::ios::binary);
+    std::vector<unsigned char> header(HEADER_SIZE, 0);
+    std::memcpy(header.data(), MAGIC, 4);
+    WriteUint32(header.data() + 4, VERSION);
+    headerFile.write((const char*)header.data(), header.size());
+    headerFile.close();
+    if (headerFile.fail()) {
+      LOG(ERROR) << "Failed to create region file: " << m_path;
+      return false;
+    }
+    m_writable = true;
+  }
+
+  std::fstream file(m_path, std::ios::in | std::ios::out | std::ios::binary);
+  if (!file.is_open()) {
+    LOG(ERROR) << "Failed to open region file: " << m_path;
+    m_mapping = MappedFile::Open(m_path);
+    return false;
+  }
+
+  int index = GetEntryIndex(localCoord);
+  Entry& entry = m_entries[index];
+
+  // Reuse the sectors the chunk already had if the payload still fits, otherwise append to the end
+  uint32_t payloadSize = (uint32_t)payload.size();
+  if (entry.offset == 0 || RoundUpToSector(payloadSize) > RoundUpToSector(entry.size)) {
+    entry.offset = std::max(m_fileSize, RoundUpToSector(HEADER_SIZE));
+    m_fileSize = entry.offset + RoundUpToSector(payloadSize);
+  }
+  entry.size = payloadSize;
+
+  file.seekp(entry.offset);
+  file.write((const char*)payload.data(), payload.size());
+
+  // Pad the last sector so the file size always stays sector aligned
+  uint32_t padding = RoundUpToSector(payloadSize) - payloadSize;
+  if (entry.offset + RoundUpToSector(payloadSize) == m_fileSize && padding > 0) {
+    std::vector<char> zeros(padding, 0);
+    file.write(zeros.data(), padding);
+  }
+
+  unsigned char entryBytes[ENTRY_SIZE];
+  WriteUint32(entryBytes, entry.offset);
+  WriteUint32(entryBytes + 4, entry.size);
+  file.seekp(TABLE_OFFSET + index * ENTRY_SIZE);
+  file.write((const char*)entryBytes, ENTRY_SIZE);
+
+  file.close();
+
+  if (file.fail()) {
+    LOG(ERROR) << "Failed to write to region file: " << m_path;
+    m_mapping = MappedFile::Open(m_path);
+    return false;
+  }
+
+  // The file grew or changed, so map it again for the readers. The entries stay valid without it, the next write
+  // still goes into the same file
+  m_mapping = MappedFile::Open(m_path);
+  if (!m_mapping.has_value()) {
+    LOG(ERROR) << "Failed to map region file: " << m_path;
+    return false;
+  }
+  return true;
+}
+
+bool RegionFile::Contains(glm::ivec2 localCoord) const {
+  std::shared_lock<std::shared_mutex> lock(m_mutex);
+  return m_entries[GetEntryIndex(localCoord)].offset != 0;
+}
+
+glm::ivec2 RegionFile::GetRegionCoord(glm::ivec2 chunkCoord) {
+  return {
+    MathUtil::FloorDiv(chunkCoord.x, REGION_WIDTH),
+    MathUtil::FloorDiv(chunkCoord.y, REGION_WIDTH)
+  };
+}
+
+glm::ivec2 RegionFile::ToLocalCoord(glm::ivec2 chunkCoord) {
+  return {
+    MathUtil::Mod(chunkCoord.x, REGION_WIDTH),
+    MathUtil::Mod(chunkCoord.y, REGION_WIDTH)
+  };
+}
+
+void RegionFile::Remap() {
+  m_mapping = MappedFile::Open(m_path);
+  m_fileSize = 0;
+  std::fill(m_entries.begin(), m_entries.end(), Entry {});
+  m_writable = false;
+
+  if (!m_mapping.has_value()) {
+    if (!IsMissingOrEmpty()) LOG(ERROR) << "Failed to map region file: " << m_path;
+    return;
+  }
+
+  const unsigned char* data = m_mapping->GetData();
+  if (m_mapping->GetSize() < HEADER_SIZE || std::memcmp(data, MAGIC, 4) != 0 || ReadUint32(data + 4) != VERSION) {
+    LOG(ERROR) << "Region file " << m_path << " is not valid, ignoring it";
+    m_mapping.reset();
+    return;
+  }
+
+  m_fileSize = RoundUpToSector((uint32_t)m_mapping->GetSize());
+  for (size_t i = 0; i < ENTRY_COUNT; i++) {
+    const unsigned char* entryBytes = data + TABLE_OFFSET + i * ENTRY_SIZE;
+    m_entries[i].offset = ReadUint32(entryBytes);
+    m_entries[i].size = ReadUint32(entryBytes + 4);
+  }
+  m_writable = true;
+}
+
+bool RegionFile::IsMissingOrEmpty() const {
+  std::error_code error;
+  if (!std::filesystem::exists(m_path, error)) return true;
+  return std::filesystem::file_size(m_path, error) == 0 && !error;
+}
+
+int RegionFile::GetEntryIndex(glm::ivec2 localCoord) const {
+  return localCoord.x + localCoord.y * REGION_WIDTH;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <shared_mutex>
+#include <cstdint>
+#include <glm/vec2.hpp>
+
+#include "util/ClassMacros.h"
+#include "util/MappedFile.h"
+
+// A region file stores the payloads of REGION_WIDTH x REGION_WIDTH chunks.
+// Layout: [magic][version][offset table: (offset, size) per chunk][payloads aligned to SECTOR_SIZE]
+// Reads go through a memory mapping of the file, writes reuse the chunk's sectors when the payload still fits
+class RegionFile {
+public:
+  DELETE_COPY(RegionFile);
+
+  explicit RegionFile(const std::string& path);
+
+  std::optional<std::vector<unsigned char>> Read(glm::ivec2 localCoord) const;
+  bool Write(glm::ivec2 localCoord, const std::vector<unsigned char>& payload);
+  bool Contains(glm::ivec2 localCoord) const;
+
+  static glm::ivec2 GetRegionCoord(glm::ivec2 chunkCoord);
+  static glm::ivec2 ToLocalCoord(glm::ivec2 chunkCoord);
+
+  static const int REGION_WIDTH;
+  static const uint32_t SECTOR_SIZE;
+
+private:
+  struct Entry {
+    uint32_t offset = 0;
+    uint32_t size = 0;
+  };
+
+  std::string m_path;
+  mutable std::shared_mutex m_mutex;
+
+  std::optional<MappedFile> m_mapping;
+  std::vector<Entry> m_entries;
+  uint32_t m_fileSize = 0;
+  // Set once the file was read as a region file of this version, files that can't be read are never written to
+  bool m_writable = false;
+
+  void Remap();
+  bool IsMissingOrEmpty() const;
+  int GetEntryIndex(glm::ivec2 localCoord) const;
+};
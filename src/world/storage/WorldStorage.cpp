@@ -0,0 +1,42 @@
+#include "WorldStorage.h"
+
+#include <filesystem>
+
+#include "util/Logging.h"
+
+WorldStorage::WorldStorage(const std::string& directory)
+  : m_directory(directory) {}
+
+std::optional<std::vector<unsigned char>> WorldStorage::LoadChunk(glm::ivec2 chunkCoord) {
+  RegionFile& region = GetRegion(RegionFile::GetRegionCoord(chunkCoord));
+  return region.Read(RegionFile::ToLocalCoord(chunkCoord));
+}
+
+bool WorldStorage::SaveChunk(glm::ivec2 chunkCoord, const std::vector<unsigned char>& payload) {
+  std::error_code error;
+  std::filesystem::create_directories(m_directory, error);
+  if (error) {
+    LOG(ERROR) << "Failed to create save directory " << m_directory << ": " << error.message();
+    return false;
+  }
+
+  RegionFile& region = GetRegion(RegionFile::GetRegionCoord(chunkCoord));
+  return region.Write(RegionFile::ToLocalCoord(chunkCoord), payload);
+}
+
+const std::string& WorldStorage::GetDirectory() const {
+  return m_directory;
+}
+
+RegionFile& WorldStorage::GetRegion(glm::ivec2 regionCoord) {
+  std::lock_guard<std::mutex> lock(m_regionsMutex);
+
+  auto it = m_regions.find(regionCoord);
+  if (it == m_regions.end()) {
+    std::string fileName = "r." + std::to_string(regionCoord.x) + "." + std::to_string(regionCoord.y) + ".lcr";
+    std::string path = (std::filesystem::path(m_directory) / fileName).string();
+    it = m_regions.emplace(regionCoord, std::make_unique<RegionFile>(path)).first;
+  }
+
+  return *it->second;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <glm/vec2.hpp>
+
+#include "util/ClassMacros.h"
+#include "util/GlmExtensions.h"
+#include "RegionFile.h"
+
+// Persists chunk payloads into region files inside a directory.
+// Safe to use from several threads, region files are opened lazily and kept open
+class WorldStorage {
+public:
+  DELETE_COPY(WorldStorage);
+
+  explicit WorldStorage(const std::string& directory);
+
+  std::optional<std::vector<unsigned char>> LoadChunk(glm::ivec2 chunkCoord);
+  bool SaveChunk(glm::ivec2 chunkCoord, const std::vector<unsigned char>& payload);
+
+  const std::string& GetDirectory() const;
+
+private:
+  std::string m_directory;
+
+  std::mutex m_regionsMutex;
+  std::unordered_map<glm::ivec2, std::unique_ptr<RegionFile>, IVec2Hash, IVec2Equal> m_regions;
+
+  RegionFile& GetRegion(glm::ivec2 regionCoord);
+};
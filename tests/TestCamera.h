@@ -0,0 +1,10 @@
+#pragma once
+
+#include "entity/Entity.h"
+
+// A world tracks an entity to know which chunks to load, tests keep it at the origin
+class TestCamera : public Entity {
+public:
+  BoundingBox GetBoundingBox() const override { return {}; }
+  double GetEyeLevel() const override { return 0.0; }
+};
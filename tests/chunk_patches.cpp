@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include "world/World.h"
+#include "world/RenderBackend.h"
+#include "init/Blocks.h"
+#include "debug/DebugSettings.h"
+#include "TestCamera.h"
+
+namespace {
+
+const int FLOATS_PER_VERTEX = 7;
+// Position and texture coordinates, the last two floats are the baked lights
+const int GEOMETRY_FLOATS = 5;
+
+using Quad = std::vector<float>;
+
+int s_patchCount = 0;
+
+// Holds a mesh in memory the way the GPU buffers would, patches included
+class MemoryMeshBuffers : public MeshBuffers {
+public:
+  void SetData(const MeshData& data, size_t vertexCapacity, size_t indexCapacity) override {
+    m_vertices = data.vertices;
+    m_vertices.resize(std::max(vertexCapacity, data.vertices.size()));
+    m_indices = data.indices;
+    m_indices.resize(std::max(indexCapacity, data.indices.size()));
+    m_indexCount = data.indices.size();
+    m_hasData = true;
+  }
+
+  bool PatchData(const float* vertices, size_t vertexOffset, size_t vertexCount,
+    const unsigned int* indices, size_t indexOffset, size_t indexCount, size_t totalIndexCount) override {
+    if (!m_hasData || vertexOffset + vertexCount > m_vertices.size() || indexOffset + indexCount > m_indices.size() ||
+      totalIndexCount > m_indices.size()) {
+      return false;
+    }
+
+    std::copy(vertices, vertices + vertexCount, m_vertices.begin() + vertexOffset);
+    std::copy(indices, indices + indexCount, m_indices.begin() + indexOffset);
+    m_indexCount = totalIndexCount;
+    s_patchCount++;
+    return true;
+  }
+
+  // The first `floatsPerVertex` floats of the vertices of every drawn quad, leaving out the degenerate ones, in a
+  // fixed order
+  std::vector<Quad> GetQuads(int floatsPerVertex) const {
+    std::vector<Quad> quads;
+    for (size_t first = 0; first + 6 <= m_indexCount; first += 6) {
+      Quad quad;
+      for (size_t i = first; i < first + 6; i++) {
+        auto vertex = m_vertices.begin() + m_indices[i] * FLOATS_PER_VERTEX;
+        quad.insert(quad.end(), vertex, vertex + floatsPerVertex);
+      }
+      if (std::any_of(quad.begin(), quad.end(), [](float value) { return value != 0.0f; })) quads.push_back(quad);
+    }
+    std::sort(quads.begin(), quads.end());
+    return quads;
+  }
+
+private:
+  std::vector<float> m_vertices;
+  std::vector<unsigned int> m_indices;
+  size_t m_indexCount = 0;
+  bool m_hasData = false;
+};
+
+class MemoryLightVolume : public LightVolumeBuffer {
+public:
+  void SetData(int, const unsigned char*) override {}
+};
+
+class MemoryRenderBackend : public RenderBackend {
+public:
+  std::unique_ptr<MeshBuffers> CreateMeshBuffers() override { return std::make_unique<MemoryMeshBuffers>(); }
+  std::unique_ptr<LightVolumeBuffer> CreateLightVolume() override { return std::make_unique<MemoryLightVolume>(); }
+};
+
+// The drawn quads of every subchunk and layer of the chunks within 1 of the origin
+std::vector<std::vector<Quad>> GetDrawnQuads(const World& world, int floatsPerVertex) {
+  std::vector<std::vector<Quad>> quads;
+  for (int x = -1; x <= 1; x++) {
+    for (int z = -1; z <= 1; z++) {
+      std::shared_ptr<Chunk> chunk = world.GetChunkAt({ x, z });
+      for (int i = 0; i < Chunk::SUBCHUNK_LAYERS; i++) {
+        for (int layer = 0; layer < RENDER_LAYER_COUNT; layer++) {
+          const MeshBuffers* buffers = chunk->GetMeshBuffers(i, (RenderLayer)layer);
+          quads.push_back(buffers ? static_cast<const MemoryMeshBuffers*>(buffers)->GetQuads(floatsPerVertex) : std::vector<Quad> {});
+        }
+      }
+    }
+  }
+  return quads;
+}
+
+// Makes seeded random edits around the origin, which are patched into the meshes, and counts the layers that don't
+// draw the same quads as a full remesh
+int CountPatchMismatches(bool useLightVolumes) {
+  s_patchCount = 0;
+  DebugSettings saved = DebugSettings::instance;
+  DebugSettings& settings = DebugSettings::instance;
+  settings.saveWorld = false;
+  settings.useTerrainCache = false;
+  settings.blockAtlasCacheFile = "";
+  settings.lodDistance = 0;
+  settings.renderDistance = 3;
+  settings.inMemoryBorder = 0;
+  settings.useLightVolumes = useLightVolumes;
+
+  Blocks::InitializeBlocks();
+  Blocks::GenerateBlockAtlas();
+  TestCamera camera;
+  MemoryRenderBackend backend;
+  World world(camera);
+  world.SetRenderBackend(&backend);
+  world.Start();
+
+  auto areaMeshed = [&]() {
+    if (world.GetChunksToGenerateTerrainSize() > 0 || world.GetChunksToLightSize() > 0 ||
+      world.GetChunksToGenerateMeshSize() > 0) return false;
+    for (int x = -1; x <= 1; x++) {
+      for (int z = -1; z <= 1; z++) {
+        std::shared_ptr<Chunk> chunk = world.GetChunkAt({ x, z });
+        if (chunk == nullptr || chunk->GetState() < APPLIED_MESH) return false;
+      }
+    }
+    return true;
+  };
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(120);
+  while (!areaMeshed() && std::chrono::steady_clock::now() < deadline) {
+    world.Update();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  EXPECT_TRUE(areaMeshed());
+
+  const Block* blocks[] = { &Blocks::AIR, &Blocks::AIR, &Blocks::AIR, &Blocks::AIR,
+    &Blocks::STONE, &Blocks::STONE, &Blocks::GLASS, &Blocks::OAK_LEAVES };
+  std::mt19937 random(5);
+  // Light volumes replace the baked lights, which aren't made again when only the light changes
+  int floatsPerVertex = useLightVolumes ? GEOMETRY_FLOATS : FLOATS_PER_VERTEX;
+
+  int mismatches = 0;
+  for (int round = 0; round < 5; round++) {
+    // Edits in a burst are patched into the subchunk after the first one
+    for (int edit = 0; edit < 40; edit++) {
+      int x = random() % Chunk::CHUNK_WIDTH;
+      int y = 50 + random() % 40;
+      int z = random() % Chunk::CHUNK_WIDTH;
+      world.UpdateBlockstateAt(x, y, z, blocks[random() % 8]->GetBlockstate());
+    }
+    std::vector<std::vector<Quad>> patched = GetDrawnQuads(world, floatsPerVertex);
+
+    for (int x = -1; x <= 1; x++) {
+      for (int z = -1; z <= 1; z++) {
+        std::shared_ptr<Chunk> chunk = world.GetChunkAt({ x, z });
+        chunk->GenerateMesh();
+        chunk->ApplyMesh();
+      }
+    }
+    std::vector<std::vector<Quad>> remeshed = GetDrawnQuads(world, floatsPerVertex);
+
+    for (size_t i = 0; i < patched.size(); i++) {
+      if (patched[i] != remeshed[i]) mismatches++;
+    }
+  }
+
+  // Otherwise every edit was remeshed and nothing was tested
+  EXPECT_GT(s_patchCount, 0);
+
+  world.Stop();
+  world.SetRenderBackend(nullptr);
+  DebugSettings::instance = saved;
+  return mismatches;
+}
+
+} // namespace
+
+TEST(ChunkPatches, MatchRemeshWithLightVolumes) {
+  EXPECT_EQ(CountPatchMismatches(true), 0);
+}
+
+TEST(ChunkPatches, MatchRemeshWithBakedLights) {
+  EXPECT_EQ(CountPatchMismatches(false), 0);
+}
@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include "world/World.h"
+#include "init/Blocks.h"
+#include "debug/DebugSettings.h"
+#include "TestCamera.h"
+
+namespace {
+
+// Payloads start with [version][kind], version 2 and kinds SNAPSHOT = 0, DELTA = 1
+const unsigned char PAYLOAD_VERSION = 2;
+const unsigned char SNAPSHOT = 0;
+const unsigned char DELTA = 1;
+
+// A started world without workers, so its chunks are only generated by the tests
+class PayloadTest : public testing::Test {
+protected:
+  void SetUp() override {
+    m_saved = DebugSettings::instance;
+    DebugSettings& settings = DebugSettings::instance;
+    settings.saveWorld = false;
+    settings.useTerrainCache = false;
+    settings.terrainWorkerCount = 0;
+    settings.lightingWorkerCount = 0;
+    settings.meshWorkerCount = 0;
+    settings.lodWorkerCount = 0;
+    settings.maxChunkEditLogSize = 8;
+
+    Blocks::InitializeBlocks();
+    m_world.Start();
+  }
+
+  void TearDown() override {
+    m_world.Stop();
+    DebugSettings::instance = m_saved;
+  }
+
+  std::shared_ptr<Chunk> MakeChunk() {
+    return std::make_shared<Chunk>(glm::ivec2 { 3, -2 }, m_world);
+  }
+
+  std::shared_ptr<Chunk> GenerateChunk() {
+    std::shared_ptr<Chunk> chunk = MakeChunk();
+    chunk->GenerateTerrain();
+    chunk->FinishTerrain();
+    return chunk;
+  }
+
+  // Places glowstone at `count` different positions
+  void Edit(Chunk& chunk, int count) {
+    for (int i = 0; i < count; i++) {
+      glm::ivec3 position = { i % Chunk::CHUNK_WIDTH, 40 + i / Chunk::CHUNK_WIDTH, 7 };
+      chunk.SetBlockstateAt(position.x, position.y, position.z, Blocks::GLOWSTONE.GetBlockstate());
+      chunk.RecordEdit(position, Blocks::GLOWSTONE.GetBlockstate());
+    }
+  }
+
+  // Loads the payload into a new chunk the way the world does, finishing the terrain for delta payloads
+  std::shared_ptr<Chunk> Load(const std::vector<unsigned char>& payload) {
+    std::shared_ptr<Chunk> chunk = MakeChunk();
+    if (!chunk->LoadTerrain(payload)) return nullptr;
+    if (chunk->GetState() < GENERATED_TERRAIN) chunk->FinishTerrain();
+    return chunk;
+  }
+
+  static bool SameBlocks(Chunk& a, Chunk& b) {
+    for (int x = 0; x < Chunk::CHUNK_WIDTH; x++) {
+      for (int y = 0; y < Chunk::CHUNK_HEIGHT; y++) {
+        for (int z = 0; z < Chunk::CHUNK_WIDTH; z++) {
+          if (a.GetBlockstateAt(x, y, z) != b.GetBlockstateAt(x, y, z)) return false;
+        }
+      }
+    }
+    return true;
+  }
+
+private:
+  DebugSettings m_saved;
+  TestCamera m_camera;
+  World m_world { m_camera };
+};
+
+} // namespace
+
+TEST_F(PayloadTest, DeltaRoundTrip) {
+  std::shared_ptr<Chunk> chunk = GenerateChunk();
+  Edit(*chunk, 5);
+
+  std::vector<unsigned char> payload = chunk->Serialize();
+  ASSERT_GE(payload.size(), 2u);
+  EXPECT_EQ(payload[0], PAYLOAD_VERSION);
+  EXPECT_EQ(payload[1], DELTA);
+  EXPECT_EQ(payload.size(), 2u + 5 * 3);
+
+  std::shared_ptr<Chunk> loaded = Load(payload);
+  ASSERT_NE(loaded, nullptr);
+  EXPECT_TRUE(SameBlocks(*chunk, *loaded));
+  EXPECT_EQ(loaded->Serialize(), payload);
+}
+
+TEST_F(PayloadTest, SnapshotRoundTrip) {
+  std::shared_ptr<Chunk> chunk = GenerateChunk();
+  Edit(*chunk, 9);
+
+  std::vector<unsigned char> payload = chunk->Serialize();
+  ASSERT_GE(payload.size(), 2u);
+  EXPECT_EQ(payload[0], PAYLOAD_VERSION);
+  EXPECT_EQ(payload[1], SNAPSHOT);
+
+  std::shared_ptr<Chunk> loaded = Load(payload);
+  ASSERT_NE(loaded, nullptr);
+  EXPECT_TRUE(SameBlocks(*chunk, *loaded));
+  EXPECT_EQ(loaded->Serialize(), payload);
+}
+
+TEST_F(PayloadTest, SnapshotOnceTheLogIsTooBig) {
+  std::shared_ptr<Chunk> chunk = GenerateChunk();
+
+  // Editing the same position again doesn't grow the log
+  Edit(*chunk, 8);
+  Edit(*chunk, 8);
+  EXPECT_EQ(chunk->Serialize()[1], DELTA);
+
+  Edit(*chunk, 9);
+  EXPECT_EQ(chunk->Serialize()[1], SNAPSHOT);
+
+  // Later edits go into the snapshot
+  chunk->SetBlockstateAt(0, 100, 0, Blocks::STONE.GetBlockstate());
+  chunk->RecordEdit({ 0, 100, 0 }, Blocks::STONE.GetBlockstate());
+  std::shared_ptr<Chunk> loaded = Load(chunk->Serialize());
+  ASSERT_NE(loaded, nullptr);
+  EXPECT_EQ(loaded->GetBlockstateAt(0, 100, 0), Blocks::STONE.GetBlockstate());
+}
+
+TEST_F(PayloadTest, LoadsVersion1Snapshots) {
+  std::shared_ptr<Chunk> chunk = GenerateChunk();
+  Edit(*chunk, 9);
+
+  // Version 1 had no kind byte, the rest of the snapshot is the same
+  std::vector<unsigned char> payload = chunk->Serialize();
+  std::vector<unsigned char> version1 = { 1 };
+  version1.insert(version1.end(), payload.begin() + 2, payload.end());
+
+  std::shared_ptr<Chunk> loaded = Load(version1);
+  ASSERT_NE(loaded, nullptr);
+  EXPECT_TRUE(SameBlocks(*chunk, *loaded));
+}
+
+TEST_F(PayloadTest, RejectsBrokenPayloads) {
+  EXPECT_FALSE(MakeChunk()->LoadTerrain({}));
+  EXPECT_FALSE(MakeChunk()->LoadTerrain({ 3, DELTA }));
+  EXPECT_FALSE(MakeChunk()->LoadTerrain({ PAYLOAD_VERSION }));
+  // Edits are 3 bytes each
+  EXPECT_FALSE(MakeChunk()->LoadTerrain({ PAYLOAD_VERSION, DELTA, 1, 0 }));
+  EXPECT_FALSE(MakeChunk()->LoadTerrain({ PAYLOAD_VERSION, SNAPSHOT, 1, 2 }));
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include "world/World.h"
+#include "voxel/CornerLightCache.h"
+#include "init/Blocks.h"
+#include "TestCamera.h"
+
+namespace {
+
+// Sky light of an UP face corner of the block at (5, 10, 5), with stone placed at the given cells above it
+float TopCornerLight(std::initializer_list<glm::ivec3> stones, glm::ivec3 corner) {
+  Blocks::InitializeBlocks();
+  TestCamera camera;
+  World world(camera);
+  std::shared_ptr<Chunk> chunk = std::make_shared<Chunk>(glm::ivec2 { 0, 0 }, world);
+
+  for (int x = 2; x < 9; x++) {
+    for (int z = 2; z < 9; z++) {
+      chunk->SetLightAt(LightType::SKY, x, 11, z, 15);
+    }
+  }
+  chunk->SetBlockstateAt(5, 10, 5, Blocks::STONE.GetBlockstate());
+  for (const glm::ivec3& stone : stones) {
+    chunk->SetBlockstateAt(stone.x, stone.y, stone.z, Blocks::STONE.GetBlockstate());
+  }
+
+  CornerLightCache lights;
+  lights.Build(*chunk, { 4, 9, 4 }, { 3, 3, 3 });
+
+  float skyLight;
+  float blockLight;
+  lights.GetCornerLight({ 5, 10, 5 }, Direction::UP, corner, skyLight, blockLight);
+  return skyLight;
+}
+
+} // namespace
+
+TEST(CornerLights, OpenCornerIsFullyLit) {
+  EXPECT_FLOAT_EQ(TopCornerLight({}, { 5, 11, 5 }), 1.0f);
+}
+
+TEST(CornerLights, SolidCellsOcclude) {
+  EXPECT_FLOAT_EQ(TopCornerLight({ {4, 11, 5} }, { 5, 11, 5 }), 0.75f);
+  EXPECT_FLOAT_EQ(TopCornerLight({ {4, 11, 5}, {4, 11, 4} }, { 5, 11, 5 }), 0.5f);
+  // Other corners of the face don't touch the stone
+  EXPECT_FLOAT_EQ(TopCornerLight({ {4, 11, 5} }, { 6, 11, 6 }), 1.0f);
+}
+
+TEST(CornerLights, LightDoesNotLeakThroughDiagonals) {
+  // Both sides are solid, so the open diagonal cell is hidden and doesn't count as light
+  EXPECT_FLOAT_EQ(TopCornerLight({ {4, 11, 5}, {5, 11, 4} }, { 5, 11, 5 }), 0.25f);
+}
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include "util/noise/DensityGrid.h"
+
+namespace {
+
+const NoiseGenerator NOISE(0);
+NoiseGenerator::Scratch scratch;
+
+double Noise3D(int x, int y, int z, double offset, double scale) {
+  return NOISE.Noise3D(x, y, z, NoiseTransform::FromScale(scale, offset, offset, offset));
+}
+
+} // namespace
+
+TEST(DensityGrid, SpacingOneMatchesNoise) {
+  DensityGrid grid;
+  grid.Sample(NOISE, scratch, -16, 0, 32, 16, 40, 16, 1, NoiseTransform::FromScale(10.0, 1000, 1000, 1000));
+
+  for (int x = -16; x < 0; x++) {
+    for (int z = 32; z < 48; z++) {
+      for (int y = 0; y < 40; y++) {
+        EXPECT_EQ(grid.Get(x, y, z), Noise3D(x, y, z, 1000, 10.0));
+      }
+    }
+  }
+}
+
+TEST(DensityGrid, InterpolatesBetweenLatticePoints) {
+  DensityGrid grid;
+  grid.Sample(NOISE, scratch, -16, 0, 32, 16, 40, 16, 4, NoiseTransform::FromScale(30.0, 0, 0, 0));
+
+  // Exact on the lattice
+  EXPECT_NEAR(grid.Get(-16, 0, 32), Noise3D(-16, 0, 32, 0, 30.0), 1e-9);
+  EXPECT_NEAR(grid.Get(-4, 36, 44), Noise3D(-4, 36, 44, 0, 30.0), 1e-9);
+
+  // Halfway along an edge
+  double expected = (Noise3D(-8, 8, 36, 0, 30.0) + Noise3D(-4, 8, 36, 0, 30.0)) / 2.0;
+  EXPECT_NEAR(grid.Get(-6, 8, 36), expected, 1e-9);
+}
+
+TEST(DensityGrid, NeighborsMatchOneLargeGrid) {
+  // A spacing that doesn't divide the chunk width, the lattice still lines up with the world grid
+  DensityGrid left, right, both;
+  left.Sample(NOISE, scratch, -16, 0, 0, 16, 20, 16, 3, NoiseTransform::FromScale(30.0, 0, 0, 0));
+  right.Sample(NOISE, scratch, 0, 0, 0, 16, 20, 16, 3, NoiseTransform::FromScale(30.0, 0, 0, 0));
+  both.Sample(NOISE, scratch, -16, 0, 0, 32, 20, 16, 3, NoiseTransform::FromScale(30.0, 0, 0, 0));
+
+  for (int x = -16; x < 16; x++) {
+    for (int z = 0; z < 16; z++) {
+      for (int y = 0; y < 20; y++) {
+        const DensityGrid& chunk = x < 0 ? left : right;
+        EXPECT_NEAR(chunk.Get(x, y, z), both.Get(x, y, z), 1e-12);
+      }
+    }
+  }
+}
@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+#include "debug/DebugSettings.h"
+
+namespace {
+
+// Stages whose hash differs between the two settings
+std::vector<GenerationStage> ChangedStages(const DebugSettings& a, const DebugSettings& b) {
+  std::vector<GenerationStage> changed;
+  for (int i = 0; i < (int)GenerationStage::COUNT; i++) {
+    if (a.GetGenerationStageHash((GenerationStage)i) != b.GetGenerationStageHash((GenerationStage)i)) {
+      changed.push_back((GenerationStage)i);
+    }
+  }
+  return changed;
+}
+
+} // namespace
+
+TEST(GenerationStages, SettingsOnlyAffectTheirStage) {
+  DebugSettings original;
+
+  DebugSettings ores = original;
+  ores.coalThreshold += 0.1;
+  EXPECT_EQ(ChangedStages(original, ores), std::vector<GenerationStage> { GenerationStage::PAINT });
+
+  DebugSettings caves = original;
+  caves.caveSpacing = 2;
+  EXPECT_EQ(ChangedStages(original, caves), std::vector<GenerationStage> { GenerationStage::SCULPT });
+
+  DebugSettings heights = original;
+  heights.octaves++;
+  EXPECT_EQ(ChangedStages(original, heights), std::vector<GenerationStage> { GenerationStage::HEIGHTMAP });
+
+  EXPECT_NE(original.GetTerrainSettingsHash(), ores.GetTerrainSettingsHash());
+}
+
+TEST(GenerationStages, SeedAffectsEveryStage) {
+  DebugSettings original;
+  DebugSettings seeded = original;
+  seeded.seed++;
+  EXPECT_EQ(ChangedStages(original, seeded).size(), (size_t)GenerationStage::COUNT);
+}
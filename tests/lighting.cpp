@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <deque>
+#include "world/World.h"
+#include "init/Blocks.h"
+#include "debug/DebugSettings.h"
+#include "TestCamera.h"
+
+namespace {
+
+// Lights of the chunks within `radius` of the origin, lit by the world's workers
+std::vector<char> LightArea(int lightingWorkers, int radius) {
+  DebugSettings saved = DebugSettings::instance;
+  DebugSettings& settings = DebugSettings::instance;
+  settings.saveWorld = false;
+  settings.useTerrainCache = false;
+  settings.lodDistance = 0;
+  // Without mesh workers nothing gets uploaded, so no graphics context is needed
+  settings.meshWorkerCount = 0;
+  settings.renderDistance = radius + 2;
+  settings.inMemoryBorder = 0;
+  settings.lightingWorkerCount = lightingWorkers;
+
+  Blocks::InitializeBlocks();
+  TestCamera camera;
+  World world(camera);
+  world.Start();
+
+  // Light only reaches the next chunk, so once every chunk within radius + 1 is lit the area can't change anymore
+  auto areaLit = [&]() {
+    for (int x = -radius - 1; x <= radius + 1; x++) {
+      for (int z = -radius - 1; z <= radius + 1; z++) {
+        std::shared_ptr<Chunk> chunk = world.GetChunkAt({ x, z });
+        if (chunk == nullptr || chunk->GetState() < PROPAGATED_LIGHTING) return false;
+      }
+    }
+    return true;
+  };
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(120);
+  while (!areaLit() && std::chrono::steady_clock::now() < deadline) {
+    world.Update();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  EXPECT_TRUE(areaLit());
+
+  std::vector<char> lights;
+  int size = (2 * radius + 1) * Chunk::CHUNK_WIDTH;
+  for (int x = 0; x < size; x++) {
+    for (int y = 0; y < Chunk::CHUNK_HEIGHT; y++) {
+      for (int z = 0; z < size; z++) {
+        int globalX = x - radius * Chunk::CHUNK_WIDTH;
+        int globalZ = z - radius * Chunk::CHUNK_WIDTH;
+        lights.push_back(world.GetLightAt(LightType::SKY, globalX, y, globalZ));
+        lights.push_back(world.GetLightAt(LightType::BLOCK, globalX, y, globalZ));
+      }
+    }
+  }
+
+  world.Stop();
+  DebugSettings::instance = saved;
+  return lights;
+}
+
+// Sets a block in a chunk of the world, without touching the lights or the meshes
+void SetBlock(World& world, int x, int y, int z, const Block& block) {
+  glm::ivec3 local = World::ToLocalCoords(x, y, z);
+  world.GetChunkAtBlockPos(x, z)->SetBlockstateAt(local.x, local.y, local.z, block.GetBlockstate());
+}
+
+void FillBox(World& world, glm::ivec3 min, glm::ivec3 max, const Block& block) {
+  for (int x = min.x; x <= max.x; x++) {
+    for (int y = min.y; y <= max.y; y++) {
+      for (int z = min.z; z <= max.z; z++) {
+        SetBlock(world, x, y, z, block);
+      }
+    }
+  }
+}
+
+// How lights used to be propagated: every lit cell of the chunks within `radius` spreads its light, one level less per
+// step, through every open cell that was darker
+void SpreadLightsPerCell(World& world, int radius) {
+  static const glm::ivec3 spreadDirections[] = { {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1} };
+  int min = -radius * Chunk::CHUNK_WIDTH;
+  int max = (radius + 1) * Chunk::CHUNK_WIDTH;
+
+  for (LightType type : { LightType::SKY, LightType::BLOCK }) {
+    std::deque<glm::ivec3> lit;
+    for (int x = min; x < max; x++) {
+      for (int y = 0; y < Chunk::CHUNK_HEIGHT; y++) {
+        for (int z = min; z < max; z++) {
+          if (world.GetLightAt(type, x, y, z) > 0) lit.push_back({ x, y, z });
+        }
+      }
+    }
+
+    while (!lit.empty()) {
+      glm::ivec3 position = lit.front();
+      lit.pop_front();
+      char value = world.GetLightAt(type, position.x, position.y, position.z) - 1;
+      if (value <= 0) continue;
+
+      for (const glm::ivec3& offset : spreadDirections) {
+        glm::ivec3 next = position + offset;
+        if (next.y < 0 || next.y >= Chunk::CHUNK_HEIGHT || world.GetChunkAtBlockPos(next.x, next.z) == nullptr) continue;
+        if (world.GetLightAt(type, next.x, next.y, next.z) >= value || world.GetBlockAt(next.x, next.y, next.z).IsSolid()) continue;
+
+        world.SetLightAt(type, next.x, next.y, next.z, value);
+        lit.push_back(next);
+      }
+    }
+  }
+}
+
+std::vector<char> GetLights(const World& world, int radius) {
+  std::vector<char> lights;
+  for (int x = -radius * Chunk::CHUNK_WIDTH; x < (radius + 1) * Chunk::CHUNK_WIDTH; x++) {
+    for (int y = 0; y < Chunk::CHUNK_HEIGHT; y++) {
+      for (int z = -radius * Chunk::CHUNK_WIDTH; z < (radius + 1) * Chunk::CHUNK_WIDTH; z++) {
+        lights.push_back(world.GetLightAt(LightType::SKY, x, y, z));
+        lights.push_back(world.GetLightAt(LightType::BLOCK, x, y, z));
+      }
+    }
+  }
+  return lights;
+}
+
+} // namespace
+
+TEST(Lighting, WorkersGiveTheSameLights) {
+  std::vector<char> single = LightArea(1, 1);
+  std::vector<char> parallel = LightArea(4, 1);
+  EXPECT_TRUE(single == parallel);
+}
+
+TEST(Lighting, SkyLightSpansMatchSpreadingEveryCell) {
+  DebugSettings saved = DebugSettings::instance;
+  DebugSettings& settings = DebugSettings::instance;
+  settings.saveWorld = false;
+  settings.useTerrainCache = false;
+  settings.lodDistance = 0;
+  settings.renderDistance = 3;
+  settings.inMemoryBorder = 0;
+  settings.terrainWorkerCount = 1;
+  // The chunks are lit by the test
+  settings.lightingWorkerCount = 0;
+  settings.meshWorkerCount = 0;
+
+  Blocks::InitializeBlocks();
+  TestCamera camera;
+  World world(camera);
+  world.Start();
+
+  // The chunks within 1 of the origin are lit, which reaches into the ones within 2 and needs their neighbors' structures
+  auto areaFinished = [&]() {
+    if (world.GetChunksToGenerateTerrainSize() > 0) return false;
+    for (int x = -2; x <= 2; x++) {
+      for (int z = -2; z <= 2; z++) {
+        std::shared_ptr<Chunk> chunk = world.GetChunkAt({ x, z });
+        if (chunk == nullptr || chunk->GetState() < GENERATED_TERRAIN) return false;
+      }
+    }
+    return true;
+  };
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(120);
+  while (!areaFinished() && std::chrono::steady_clock::now() < deadline) {
+    world.Update();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  ASSERT_TRUE(areaFinished());
+
+  // A cliff along the border at x = 0 with a deep pit in front of it
+  FillBox(world, { -8, 1, -8 }, { -1, 150, 8 }, Blocks::STONE);
+  FillBox(world, { 0, 20, -8 }, { 6, 150, 8 }, Blocks::AIR);
+  // An overhang over the corner where four chunks meet, with a glowstone below it
+  FillBox(world, { 8, 90, 8 }, { 24, 99, 24 }, Blocks::AIR);
+  FillBox(world, { 8, 100, 8 }, { 24, 100, 24 }, Blocks::STONE);
+  SetBlock(world, 15, 95, 16, Blocks::GLOWSTONE);
+
+  auto resetLights = [&]() {
+    for (int x = -2; x <= 2; x++) {
+      for (int z = -2; z <= 2; z++) {
+        world.GetChunkAt({ x, z })->FinishTerrain();
+      }
+    }
+  };
+
+  resetLights();
+  for (int x = -1; x <= 1; x++) {
+    for (int z = -1; z <= 1; z++) {
+      world.GetChunkAt({ x, z })->PropagateLighting();
+    }
+  }
+  std::vector<char> spans = GetLights(world, 2);
+
+  // The light reaches under the overhang from its sides only
+  char underOverhang = world.GetLightAt(LightType::SKY, 16, 92, 16);
+  EXPECT_GT(underOverhang, 0);
+  EXPECT_LT(underOverhang, 14);
+
+  resetLights();
+  SpreadLightsPerCell(world, 1);
+  std::vector<char> perCell = GetLights(world, 2);
+
+  world.Stop();
+  DebugSettings::instance = saved;
+
+  EXPECT_TRUE(spans == perCell);
+}
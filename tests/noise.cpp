@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "util/Noise.h"
+#include "util/noise/NoiseGenerator.h"
+
+namespace {
+
+// Runs the test body with every kernel the CPU supports, including the scalar fallback
+template <typename Func>
+void ForEachKernel(Func func) {
+  const NoiseKernels::Kernel* previous = Noise::GetBatchKernel();
+  for (const NoiseKernels::Kernel* kernel : Noise::GetSupportedKernels()) {
+    Noise::SetBatchKernel(kernel);
+    SCOPED_TRACE(kernel ? kernel->name : "scalar");
+    func();
+  }
+  Noise::SetBatchKernel(previous);
+}
+
+} // namespace
+
+TEST(Noise, GridMatchesScalar) {
+  ForEachKernel([]() {
+    // Odd sizes so the scalar remainder is used too
+    const int width = 17;
+    const int height = 15;
+    NoiseGenerator noise(0);
+    NoiseGenerator::Scratch scratch;
+    FractalNoise2D fractal = FractalNoise2D::FromScale(100.0, 0.5, -3.0, 5, 0.6, 1.8);
+    std::vector<double> grid(width * height);
+    noise.Noise2DGrid(scratch, -40, 23, width, height, fractal, grid.data());
+
+    // Bit for bit, chunks and single block probes take different paths and must see the same terrain
+
+    for (int x = 0; x < width; x++) {
+      for (int y = 0; y < height; y++) {
+        double expected = noise.Noise2D(-40 + x, 23 + y, fractal);
+        EXPECT_EQ(grid[x * height + y], expected);
+      }
+    }
+  });
+}
+
+TEST(Noise, BlockMatchesScalar) {
+  ForEachKernel([]() {
+    // Small scale so every simplex region and extra vertex case is hit
+    const int width = 13;
+    const int height = 21;
+    const int depth = 11;
+    NoiseGenerator noise(0);
+    NoiseGenerator::Scratch scratch;
+    NoiseTransform transform = NoiseTransform::FromScale(2.7, 1000, 1000, 1000);
+    std::vector<double> block(width * height * depth);
+    noise.Noise3DBlock(scratch, -7, 40, 5, width, height, depth, transform, block.data());
+
+    for (int x = 0; x < width; x++) {
+      for (int z = 0; z < depth; z++) {
+        for (int y = 0; y < height; y++) {
+          double expected = noise.Noise3D(-7 + x, 40 + y, 5 + z, transform);
+          EXPECT_EQ(block[(x * depth + z) * height + y], expected);
+        }
+      }
+    }
+  });
+}
+
+TEST(Noise, GeneratorsOnlyDependOnTheirSeed) {
+  NoiseGenerator first(42), second(7), sameAsFirst(42);
+  NoiseTransform transform = NoiseTransform::FromScale(10.0, 0, 0, 0);
+
+  // Generators don't share state, so making the second one doesn't change the first
+  int differences = 0;
+  for (int x = 0; x < 16; x++) {
+    EXPECT_EQ(first.Noise3D(x, 3, 5, transform), sameAsFirst.Noise3D(x, 3, 5, transform));
+    differences += first.Noise3D(x, 3, 5, transform) != second.Noise3D(x, 3, 5, transform);
+  }
+  EXPECT_GT(differences, 0);
+}
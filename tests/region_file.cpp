@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include "util/Compression.h"
+#include "world/storage/RegionFile.h"
+#include "world/storage/WorldStorage.h"
+
+namespace {
+
+std::filesystem::path MakeTempDirectory(const std::string& name) {
+  std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+  std::filesystem::remove_all(path);
+  std::filesystem::create_directories(path);
+  return path;
+}
+
+std::vector<unsigned char> MakePayload(size_t size, unsigned char seed) {
+  std::vector<unsigned char> payload(size);
+  for (size_t i = 0; i < size; i++) {
+    payload[i] = (i / 37) % 3 == 0 ? seed : (unsigned char)(i * 7 + seed);
+  }
+  return payload;
+}
+
+std::vector<unsigned char> ReadFileBytes(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::vector<unsigned char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void WriteVersion(const std::string& path, unsigned char version) {
+  std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+  file.seekp(4);
+  file.put((char)version);
+}
+
+} // namespace
+
+TEST(Compression, RunLengthRoundTrip) {
+  std::vector<unsigned char> data(5000, 0);
+  for (size_t i = 1000; i < 1300; i++) data[i] = (unsigned char)i;
+  for (size_t i = 2000; i < 2002; i++) data[i] = 9;
+
+  std::vector<unsigned char> encoded;
+  Compression::RunLengthEncode(data.data(), data.size(), encoded);
+  EXPECT_LT(encoded.size(), data.size());
+
+  std::vector<unsigned char> decoded(data.size());
+  ASSERT_TRUE(Compression::RunLengthDecode(encoded.data(), encoded.size(), decoded.data(), decoded.size()));
+  EXPECT_EQ(decoded, data);
+
+  // Decoding into the wrong size must fail instead of overflowing
+  std::vector<unsigned char> tooSmall(data.size() - 1);
+  EXPECT_FALSE(Compression::RunLengthDecode(encoded.data(), encoded.size(), tooSmall.data(), tooSmall.size()));
+}
+
+TEST(RegionFile, RoundTrip) {
+  std::filesystem::path directory = MakeTempDirectory("luiscraft_region_test");
+  std::string path = (directory / "r.0.0.lcr").string();
+
+  std::vector<unsigned char> first = MakePayload(100, 1);
+  std::vector<unsigned char> second = MakePayload(3 * RegionFile::SECTOR_SIZE + 5, 2);
+
+  {
+    RegionFile region(path);
+    EXPECT_FALSE(region.Contains({ 0, 0 }));
+    EXPECT_FALSE(region.Read({ 0, 0 }).has_value());
+
+    ASSERT_TRUE(region.Write({ 0, 0 }, first));
+    ASSERT_TRUE(region.Write({ 31, 31 }, second));
+    EXPECT_EQ(region.Read({ 0, 0 }), first);
+    EXPECT_EQ(region.Read({ 31, 31 }), second);
+  }
+
+  // Reopening reads back from the file
+  RegionFile region(path);
+  EXPECT_EQ(region.Read({ 0, 0 }), first);
+  EXPECT_EQ(region.Read({ 31, 31 }), second);
+  EXPECT_FALSE(region.Contains({ 5, 5 }));
+
+  // Growing a payload past its sectors moves it without touching the others
+  std::vector<unsigned char> grown = MakePayload(2 * RegionFile::SECTOR_SIZE, 3);
+  ASSERT_TRUE(region.Write({ 0, 0 }, grown));
+  EXPECT_EQ(region.Read({ 0, 0 }), grown);
+  EXPECT_EQ(region.Read({ 31, 31 }), second);
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(RegionFile, UnreadableFileIsNeverOverwritten) {
+  std::filesystem::path directory = MakeTempDirectory("luiscraft_region_unreadable_test");
+  std::string path = (directory / "r.0.0.lcr").string();
+
+  std::vector<unsigned char> first = MakePayload(100, 1);
+  std::vector<unsigned char> second = MakePayload(RegionFile::SECTOR_SIZE + 1, 2);
+  std::vector<unsigned char> third = MakePayload(300, 3);
+  {
+    RegionFile region(path);
+    ASSERT_TRUE(region.Write({ 0, 0 }, first));
+    ASSERT_TRUE(region.Write({ 1, 0 }, second));
+  }
+
+  // A newer version can't be mapped, writing must fail without touching the file
+  WriteVersion(path, 2);
+  std::vector<unsigned char> unreadable = ReadFileBytes(path);
+  {
+    RegionFile region(path);
+    EXPECT_FALSE(region.Contains({ 0, 0 }));
+    EXPECT_FALSE(region.Write({ 2, 0 }, third));
+    EXPECT_FALSE(region.Write({ 2, 0 }, third));
+  }
+  EXPECT_EQ(ReadFileBytes(path), unreadable);
+
+  // Once it can be read again the chunks are all still there
+  WriteVersion(path, 1);
+  {
+    RegionFile region(path);
+    ASSERT_TRUE(region.Write({ 2, 0 }, third));
+    EXPECT_EQ(region.Read({ 0, 0 }), first);
+    EXPECT_EQ(region.Read({ 1, 0 }), second);
+    EXPECT_EQ(region.Read({ 2, 0 }), third);
+  }
+
+  // A removed file starts over, without the chunks it had
+  RegionFile region(path);
+  std::filesystem::remove(path);
+  ASSERT_TRUE(region.Write({ 3, 0 }, first));
+  EXPECT_FALSE(region.Contains({ 0, 0 }));
+  EXPECT_EQ(region.Read({ 3, 0 }), first);
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(RegionFile, ChunkCoordinates) {
+  EXPECT_EQ(RegionFile::GetRegionCoord({ 0, 31 }), glm::ivec2(0, 0));
+  EXPECT_EQ(RegionFile::GetRegionCoord({ -1, 32 }), glm::ivec2(-1, 1));
+  EXPECT_EQ(RegionFile::ToLocalCoord({ -1, 32 }), glm::ivec2(31, 0));
+  // Large enough that a float can't hold it exactly
+  EXPECT_EQ(RegionFile::GetRegionCoord({ 16777247, -16777249 }), glm::ivec2(524288, -524290));
+}
+
+TEST(WorldStorage, RoundTrip) {
+  std::filesystem::path directory = MakeTempDirectory("luiscraft_storage_test");
+  std::vector<unsigned char> payload = MakePayload(500, 4);
+
+  {
+    WorldStorage storage(directory.string());
+    ASSERT_TRUE(storage.SaveChunk({ -40, 7 }, payload));
+  }
+
+  WorldStorage storage(directory.string());
+  EXPECT_EQ(storage.LoadChunk({ -40, 7 }), payload);
+  EXPECT_FALSE(storage.LoadChunk({ -40, 8 }).has_value());
+
+  std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,33 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include "util/threadsafe/TaskPool.h"
+
+TEST(TaskPool, RunsEveryIndexOnce) {
+  std::vector<std::atomic<int>> runs(1000);
+  TaskPool::GetInstance().ParallelFor(runs.size(), [&](int i) {
+    runs[i]++;
+  });
+
+  for (const std::atomic<int>& count : runs) {
+    EXPECT_EQ(count, 1);
+  }
+}
+
+TEST(TaskPool, SeveralCallersAtOnce) {
+  std::atomic<int> total = 0;
+  std::vector<std::thread> callers;
+  for (int i = 0; i < 4; i++) {
+    callers.push_back(std::thread([&]() {
+      for (int j = 0; j < 50; j++) {
+        TaskPool::GetInstance().ParallelFor(8, [&](int) { total++; });
+      }
+    }));
+  }
+
+  for (std::thread& caller : callers) {
+    caller.join();
+  }
+  EXPECT_EQ(total, 4 * 50 * 8);
+}
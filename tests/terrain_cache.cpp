@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "world/World.h"
+#include "world/storage/WorldStorage.h"
+#include "init/Blocks.h"
+#include "debug/DebugSettings.h"
+#include "TestCamera.h"
+
+namespace {
+
+// The directory World::OpenTerrainCache uses for the current settings
+std::filesystem::path GetCacheDirectory() {
+  std::stringstream key;
+  key << DebugSettings::instance.seed << "-" << std::hex << DebugSettings::instance.GetTerrainSettingsHash();
+  return std::filesystem::path(DebugSettings::instance.terrainCacheDirectory) / key.str();
+}
+
+} // namespace
+
+TEST(TerrainCache, RegeneratingDropsChunksWaitingToBeReclaimed) {
+  std::filesystem::path root = std::filesystem::temp_directory_path() / "luiscraft_terrain_cache_test";
+  std::filesystem::remove_all(root);
+
+  DebugSettings saved = DebugSettings::instance;
+  DebugSettings& settings = DebugSettings::instance;
+  settings.saveWorld = false;
+  settings.useTerrainCache = true;
+  settings.terrainCacheDirectory = root.string();
+  settings.blockAtlasCacheFile = "";
+  settings.lodDistance = 0;
+  settings.renderDistance = 4;
+  settings.inMemoryBorder = 0;
+
+  Blocks::InitializeBlocks();
+  Blocks::GenerateBlockAtlas();
+  TestCamera camera;
+  World world(camera);
+  world.Start();
+
+  auto meshed = [&]() {
+    if (world.GetActiveChunks().empty() || world.GetChunksToGenerateTerrainSize() > 0 ||
+      world.GetChunksToLightSize() > 0 || world.GetChunksToGenerateMeshSize() > 0) return false;
+    std::shared_ptr<Chunk> chunk = world.GetChunkAt({ 0, 0 });
+    return chunk != nullptr && chunk->GetState() >= GENERATED_MESH;
+  };
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(120);
+  while (!meshed() && std::chrono::steady_clock::now() < deadline) {
+    world.Update();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  ASSERT_TRUE(meshed());
+
+  // Queues every cacheable chunk for the reclaimer at once, so most of them are still waiting when the settings change
+  std::vector<glm::ivec2> removed;
+  for (const std::shared_ptr<Chunk>& chunk : world.GetActiveChunks()) {
+    if (chunk->IsCacheable()) removed.push_back(chunk->GetChunkCoord());
+  }
+  ASSERT_FALSE(removed.empty());
+  for (glm::ivec2 coord : removed) {
+    world.RemoveChunk(coord);
+  }
+
+  // Ores are painted, so only the later stages run again
+  settings.coalThreshold += 0.1;
+  world.Regenerate();
+  deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+  while (world.GetChunksToReclaimSize() > 0 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  world.Stop();
+
+  // Nothing was generated with the new settings, so the new cache can't have any of the old chunks
+  WorldStorage cache(GetCacheDirectory().string());
+  for (glm::ivec2 coord : removed) {
+    EXPECT_FALSE(cache.LoadChunk(coord).has_value()) << "Chunk " << coord.x << ", " << coord.y;
+  }
+
+  DebugSettings::instance = saved;
+  std::filesystem::remove_all(root);
+}